@@ -0,0 +1,33 @@
+/*
+ * list_store_sort.js
+ *
+ * Sorts a Gio.ListStore with a JS comparator, and reports the comparator
+ * calls per second. Usage: node benchmarks/list_store_sort.js [count]
+ *
+ * GCompareDataFunc arguments are untyped pointers, which aren't converted:
+ * the comparator orders the items by the sequence of its calls, so this
+ * measures the cost of the callback invocations themselves.
+ */
+
+
+const gi = require('../lib/')
+const Gio = gi.require('Gio', '2.0')
+const Gtk = gi.require('Gtk', '3.0')
+
+Gtk.init()
+
+const count = Number(process.argv[2]) || 100000
+
+const store = Gio.ListStore.new(Gtk.Label.gtype)
+const label = new Gtk.Label()
+for (let i = 0; i < count; i++)
+  store.append(label)
+
+let calls = 0
+const comparator = () => (calls++ % 3) - 1
+
+const start = process.hrtime.bigint()
+store.sort(comparator)
+const elapsed = Number(process.hrtime.bigint() - start) / 1e9
+
+console.log(`sort ${count} items: ${calls} comparator calls in ${elapsed.toFixed(3)}s (${Math.round(calls / elapsed)}/s)`)
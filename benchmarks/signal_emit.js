@@ -0,0 +1,48 @@
+/*
+ * signal_emit.js
+ *
+ * Emits signals to JS handlers in a loop, and reports the emissions per
+ * second. Usage: node benchmarks/signal_emit.js [count]
+ */
+
+
+const gi = require('../lib/')
+const Gio = gi.require('Gio', '2.0')
+const Gtk = gi.require('Gtk', '3.0')
+
+Gtk.init()
+
+const count = Number(process.argv[2]) || 1000000
+
+function bench(name, setup) {
+  let calls = 0
+  const emit = setup(() => { calls++ })
+
+  const start = process.hrtime.bigint()
+  for (let i = 0; i < count; i++)
+    emit(i)
+  const elapsed = Number(process.hrtime.bigint() - start) / 1e9
+
+  if (calls !== count)
+    throw new Error(`${name}: expected ${count} calls, got ${calls}`)
+
+  console.log(`${name}: ${count} emissions in ${elapsed.toFixed(3)}s (${Math.round(count / elapsed)}/s)`)
+}
+
+bench('clicked (no arguments)', handler => {
+  const button = new Gtk.Button()
+  button.connect('clicked', handler)
+  return () => button.clicked()
+})
+
+bench('items-changed (3 × guint)', handler => {
+  const store = new Gio.ListStore({ itemType: Gtk.Button.gtype })
+  store.connect('items-changed', (position, removed, added) => handler())
+  return i => store.itemsChanged(i, 0, 0)
+})
+
+bench('value-changed + notify (GParamSpec)', handler => {
+  const adjustment = new Gtk.Adjustment({ lower: 0, upper: count, stepIncrement: 1 })
+  adjustment.connect('notify::value', (pspec) => handler())
+  return i => adjustment.setValue(i + 1)
+})
@@ -5,17 +5,23 @@
             "sources": [
                 "src/boxed.cc",
                 "src/callback.cc",
+                "src/census.cc",
                 "src/closure.cc",
                 "src/debug.cc",
                 "src/error.cc",
+                "src/finalization.cc",
                 "src/function.cc",
                 "src/gi.cc",
                 "src/gobject.cc",
+                "src/heap_graph.cc",
                 "src/loop.cc",
+                "src/memory.cc",
                 "src/param_spec.cc",
+                "src/region.cc",
                 "src/type.cc",
                 "src/util.cc",
                 "src/value.cc",
+                "src/variant.cc",
                 "src/modules/system.cc",
             ],
             "include_dirs" : [
@@ -26,7 +32,7 @@
             ],
             "ldflags": [
                 "-Wl,-no-as-needed",
-                "<!@(pkg-config --libs gobject-introspection-1.0)",
+                "<!@(pkg-config --libs gobject-introspection-1.0 gmodule-2.0)",
             ],
             "conditions": [
                 ['OS != "linux"', {
@@ -40,7 +46,7 @@
                             "<!@(pkg-config --cflags glib-2.0 gobject-introspection-1.0)",
                         ],
                         "OTHER_LDFLAGS": [
-                            "<!@(pkg-config --libs gobject-introspection-1.0)",
+                            "<!@(pkg-config --libs gobject-introspection-1.0 gmodule-2.0)",
                         ]
                     },
                 }],
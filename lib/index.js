@@ -5,6 +5,7 @@
 const camelCase = require('lodash.camelcase')
 
 const internal = require('./native.js')
+const StructArrayView = require('./struct_array.js')
 
 // The bootstrap from C here contains functions and methods for each object,
 // namespaced with underscores. See gi.cc for more information.
@@ -44,24 +45,36 @@ const GObject = internal.GetBaseClass()
 extendGObject(GObject)
 
 function extendGObject(GObject) {
+    // Kept out of the instances, so that wrappers of a class share one shape
+    const listenersByObject = new WeakMap()
+
+    function getListeners(object) {
+        let listeners = listenersByObject.get(object)
+        if (listeners === undefined) {
+            listeners = new Map()
+            listenersByObject.set(object, listeners)
+        }
+        return listeners
+    }
+
     GObject.prototype.on = function on(event, callback) {
-        defineListeners(this)
+        const listeners = getListeners(this)
 
-        if (!this._listeners.has(event))
-            this._listeners.set(event, new WeakMap())
+        if (!listeners.has(event))
+            listeners.set(event, new WeakMap())
 
-        const fnMap = this._listeners.get(event)
+        const fnMap = listeners.get(event)
         const handlerID = this.connect(event, callback)
         fnMap.set(callback, handlerID)
     }
 
     GObject.prototype.off = function off(event, callback) {
-        defineListeners(this)
+        const listeners = getListeners(this)
 
-        if (!this._listeners.has(event))
+        if (!listeners.has(event))
             return
 
-        const fnMap = this._listeners.get(event)
+        const fnMap = listeners.get(event)
         if (!fnMap.has(callback))
             return
 
@@ -78,13 +91,9 @@ function extendGObject(GObject) {
         this.on(event, newCallback)
     }
 
-    function defineListeners(object) {
-        if (object._listeners !== undefined)
-            return
-        Object.defineProperty(object, '_listeners', {
-            value: new Map()
-        })
-    }
+    // Explicit resource management (`using obj = ...`)
+    if (typeof Symbol.dispose === 'symbol')
+        GObject.prototype[Symbol.dispose] = GObject.prototype.dispose
 }
 
 
@@ -121,13 +130,14 @@ function getFunctionDescription(info) {
 }
 
 function getPropertyDescription(info) {
-    const propertyName = getName(info)
     const name = getInfoName(info)
+    // Native accessors, with the GParamSpec cached per class
+    const { get, set } = internal.MakePropertyAccessors(info)
     const property = {
         configurable: true,
         enumerable: true,
-        get: propertyGetter(propertyName),
-        set: propertySetter(propertyName),
+        get,
+        set,
     }
     return { name, property, isProperty: true }
 }
@@ -180,6 +190,10 @@ function addField(object, fieldInfo) {
 
     const name = getInfoName(fieldInfo)
 
+    // Scalar fields get native accessors with a precomputed offset
+    if (internal.DefineStructField(object, fieldInfo, name))
+        return
+
     Object.defineProperty(object, name, {
         configurable: true,
         enumerable: readable,
@@ -188,18 +202,6 @@ function addField(object, fieldInfo) {
     })
 }
 
-function propertyGetter(propertyName) {
-    return function() {
-        return internal.ObjectPropertyGetter(this, propertyName);
-    };
-}
-
-function propertySetter(propertyName) {
-    return function(value) {
-        return internal.ObjectPropertySetter(this, propertyName, value);
-    };
-}
-
 function addProperty(object, info) {
     define(object, getPropertyDescription(info))
 }
@@ -260,6 +262,10 @@ function makeEnum(info) {
 function makeObject(info) {
     const constructor = internal.MakeObjectClass(info);
 
+    Object.defineProperty(constructor, 'gtype', {
+        value: GI.registered_type_info_get_g_type(info)
+    })
+
     loop(info, GI.object_info_get_n_properties, GI.object_info_get_property, (propertyInfo) => {
         addProperty(constructor, propertyInfo)
     })
@@ -488,6 +494,7 @@ function giRequire(ns, version) {
     const repo = GI.Repository_get_default()
     GI.Repository_require.call(repo, ns, version || null, 0)
     version = version || GI.Repository_get_version.call(repo, ns)
+    internal.NamespaceLoaded()
 
     loadDependencies(ns, version)
 
@@ -561,6 +568,75 @@ function prependLibraryPath(path) {
 }
 
 
+/**
+ * Enables or disables BigInt conversion of 64-bit integers and GTypes.
+ * By default, they are converted to numbers, which lose precision above 2^53.
+ * @param {boolean} enabled
+ * @param {string} [ns=null] - namespace to apply it to (null for all)
+ */
+function setBigIntMode(enabled, ns) {
+    internal.SetBigIntMode(enabled, ns || null)
+}
+
+
+/**
+ * Calls fn() in an allocation region: boxed values allocated inside it
+ * (eg. `new Gdk.Rectangle()`, caller-allocated out-arguments) are released
+ * in one shot when it returns, instead of waiting for the GC. Using them
+ * afterwards throws.
+ * @param {Function} fn
+ * @returns {any} the return value of fn
+ */
+function withRegion(fn) {
+    internal.RegionEnter()
+    try {
+        return fn()
+    } finally {
+        internal.RegionExit()
+    }
+}
+
+
+/**
+ * Enables caching of the values of some properties, for instances of
+ * a class and its subclasses. Repeated reads return the last value until
+ * the property emits `notify`: only use it for properties that notify
+ * reliably. Only primitive values (numbers, strings, booleans) are cached.
+ * @param {Function} klass - a GObject class, eg. Gtk.Widget
+ * @param {string[]} names - property names
+ */
+function enablePropertyCache(klass, names) {
+    internal.SetPropertyCache(klass.gtype, names, true)
+}
+
+/**
+ * Disables caching of the values of some properties, eg. for a subclass
+ * whose properties don't notify reliably. See enablePropertyCache().
+ * @param {Function} klass - a GObject class, eg. Gtk.Label
+ * @param {string[]} names - property names
+ */
+function disablePropertyCache(klass, names) {
+    internal.SetPropertyCache(klass.gtype, names, false)
+}
+
+
+/**
+ * Calls fn() with property notifications batched: every object whose
+ * properties are set inside it is frozen once, and emits its coalesced
+ * `notify` signals when fn returns.
+ * @param {Function} fn
+ * @returns {any} the return value of fn
+ */
+function batchNotify(fn) {
+    internal.BatchNotifyBegin()
+    try {
+        return fn()
+    } finally {
+        internal.BatchNotifyEnd()
+    }
+}
+
+
 /*
  * Exports
  */
@@ -570,7 +646,13 @@ exports.require = giRequire
 exports.startLoop = internal.StartLoop
 exports.prependSearchPath = prependSearchPath
 exports.prependLibraryPath = prependLibraryPath
+exports.setBigIntMode = setBigIntMode
+exports.withRegion = withRegion
+exports.batchNotify = batchNotify
+exports.enablePropertyCache = enablePropertyCache
+exports.disablePropertyCache = disablePropertyCache
 exports.System = internal.System
+exports.StructArrayView = StructArrayView
 
 // Private API
 exports._isLoaded = _isLoaded
@@ -22,4 +22,17 @@ exports.apply = (GLib) => {
         this._userQuit = true
         this._quit()
     }
+
+    /*
+     * GLib.Variant: native (un)packing, without one introspected call per element
+     */
+
+    GLib.Variant.prototype.deepUnpack = function deepUnpack() {
+        return internal.VariantDeepUnpack(this)
+    }
+    GLib.Variant.prototype.recursiveUnpack = GLib.Variant.prototype.deepUnpack
+
+    GLib.Variant.pack = function pack(type, value) {
+        return internal.VariantPack(type, value)
+    }
 }
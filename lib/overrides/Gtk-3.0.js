@@ -2,8 +2,6 @@
  * Gtk-3.0.js
  */
 
-const gi = require('../../lib/index.js')
-const GObject = gi.require('GObject')
 const internal = require('../native.js')
 
 /**
@@ -79,26 +77,6 @@ exports.apply = (Gtk) => {
    * Gtk.Builder
    */
 
-  /**
-   * Gtk.Builder.prototype.getObject
-   * @returns {GObject}
-   */
-  const getObject = Gtk.Builder.prototype.getObject
-  Gtk.Builder.prototype.getObject = function(name) {
-    const object = getObject.call(this, name)
-    const typeName = GObject.typeName(object.__gtype__)
-
-    if (typeName.startsWith('Gtk')) {
-      const klass = Gtk[typeName.replace(/^Gtk/, '')]
-
-      if (klass) {
-        object.__proto__ = klass.prototype
-      }
-    }
-
-    return object
-  }
-
   /**
    * Gtk.Builder.prototype.connectSignals
    * @returns void
@@ -0,0 +1,89 @@
+/*
+ * struct_array.js
+ */
+
+const internal = require('./native.js')
+
+module.exports = StructArrayView
+
+// Storage type (as given by g_type_tag_to_string) => TypedArray
+const typedArrayByTag = {
+    gboolean: Int32Array,
+    gint8:    Int8Array,
+    guint8:   Uint8Array,
+    gint16:   Int16Array,
+    guint16:  Uint16Array,
+    gint32:   Int32Array,
+    guint32:  Uint32Array,
+    gint64:   BigInt64Array,
+    guint64:  BigUint64Array,
+    gfloat:   Float32Array,
+    gdouble:  Float64Array,
+    GType:    BigUint64Array,
+}
+
+/**
+ * A view over a contiguous array of C structs (eg. GdkPoint[]), returned
+ * instead of one boxed wrapper per element. Scalar fields are accessed
+ * through strided TypedArrays: `view.fields.x.get(i)`.
+ * Views can be passed back to functions expecting an array of the same struct.
+ */
+function StructArrayView(structClass, buffer, length, stride, layout) {
+    this.structClass = structClass
+    this.buffer = buffer
+    this.length = length
+    this.stride = stride
+    this.fields = {}
+
+    layout.forEach(([name, offset, tag]) => {
+        Object.defineProperty(this.fields, name, {
+            enumerable: true,
+            value: new StructArrayField(this, offset, tag)
+        })
+    })
+}
+
+StructArrayView.prototype[Symbol.iterator] = function* () {
+    const names = Object.keys(this.fields)
+    for (let i = 0; i < this.length; i++) {
+        const record = {}
+        names.forEach(name => { record[name] = this.fields[name].get(i) })
+        yield record
+    }
+}
+
+/**
+ * Strided accessor for one field of a StructArrayView
+ */
+function StructArrayField(view, offset, tag) {
+    const TypedArray = typedArrayByTag[tag]
+    const size = TypedArray.BYTES_PER_ELEMENT
+
+    // C fields are naturally aligned, so this only fails on odd ABIs
+    if (offset % size !== 0 || view.stride % size !== 0)
+        throw new Error(`Unaligned struct array field (offset ${offset}, stride ${view.stride})`)
+
+    this.array = new TypedArray(view.buffer, 0, Math.floor(view.buffer.byteLength / size))
+    this.start = offset / size
+    this.step = view.stride / size
+    this.length = view.length
+    this.isBoolean = tag === 'gboolean'
+}
+
+StructArrayField.prototype.get = function get(index) {
+    const value = this.array[this.start + index * this.step]
+    return this.isBoolean ? value !== 0 : value
+}
+
+StructArrayField.prototype.set = function set(index, value) {
+    this.array[this.start + index * this.step] = this.isBoolean ? Number(Boolean(value)) : value
+}
+
+StructArrayField.prototype.toArray = function toArray() {
+    const result = new Array(this.length)
+    for (let i = 0; i < this.length; i++)
+        result[i] = this.get(i)
+    return result
+}
+
+internal.RegisterStructArrayView(StructArrayView)
@@ -1,14 +1,20 @@
 
 #include <girepository.h>
 #include <glib.h>
+#include <string.h>
 
 #include "boxed.h"
+#include "census.h"
 #include "debug.h"
 #include "error.h"
+#include "finalization.h"
 #include "function.h"
 #include "gi.h"
 #include "gobject.h"
+#include "heap_graph.h"
 #include "macros.h"
+#include "memory.h"
+#include "region.h"
 #include "type.h"
 #include "util.h"
 #include "value.h"
@@ -135,8 +141,230 @@ static GIFunctionInfo* FindBoxedConstructor (GIBaseInfo* info, GType gtype) {
     return fn_info;
 }
 
+/*
+ * Small plain-old-data structs (no owned pointers, no custom free function
+ * needed) allocated by us live in an ArrayBuffer held by the wrapper.
+ */
+
+#define INLINE_STORAGE_MAX_SIZE 64
+
+static GHashTable *inlineStorageCache = NULL;
+
+static bool IsPlainOldData (GIBaseInfo *info);
+
+static bool IsPlainOldDataField (GIFieldInfo *field) {
+    GITypeInfo *type_info = g_field_info_get_type (field);
+    GITypeTag tag = g_type_info_get_tag (type_info);
+    bool result = false;
+
+    if (g_type_info_is_pointer (type_info)) {
+        /* Untyped pointers (eg. GtkTreeIter.user_data) are never owned */
+        result = tag == GI_TYPE_TAG_VOID;
+    } else if (tag == GI_TYPE_TAG_INTERFACE) {
+        GIBaseInfo *interface_info = g_type_info_get_interface (type_info);
+        switch (g_base_info_get_type (interface_info)) {
+            case GI_INFO_TYPE_ENUM:
+            case GI_INFO_TYPE_FLAGS:
+                result = true;
+                break;
+            case GI_INFO_TYPE_STRUCT:
+            case GI_INFO_TYPE_UNION:
+                result = IsPlainOldData (interface_info);
+                break;
+            default:
+                break;
+        }
+        g_base_info_unref (interface_info);
+    } else {
+        result = G_TYPE_TAG_IS_BASIC (tag)
+            && tag != GI_TYPE_TAG_UTF8
+            && tag != GI_TYPE_TAG_FILENAME;
+    }
+
+    g_base_info_unref (type_info);
+    return result;
+}
+
+static bool IsPlainOldData (GIBaseInfo *info) {
+    bool is_union = g_base_info_get_type (info) == GI_INFO_TYPE_UNION;
+
+    if (!is_union && g_struct_info_is_foreign ((GIStructInfo *) info))
+        return false;
+
+    int n_fields = is_union ?
+        g_union_info_get_n_fields ((GIUnionInfo *) info) :
+        g_struct_info_get_n_fields ((GIStructInfo *) info);
+
+    if (n_fields == 0)
+        return false;
+
+    for (int i = 0; i < n_fields; i++) {
+        GIFieldInfo *field = is_union ?
+            g_union_info_get_field ((GIUnionInfo *) info, i) :
+            g_struct_info_get_field ((GIStructInfo *) info, i);
+        bool is_pod = IsPlainOldDataField (field);
+        g_base_info_unref (field);
+
+        if (!is_pod)
+            return false;
+    }
+
+    return true;
+}
+
+static bool UseInlineStorage (GIBaseInfo *info, size_t size) {
+    if (size > INLINE_STORAGE_MAX_SIZE)
+        return false;
+
+    if (inlineStorageCache == NULL)
+        inlineStorageCache = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    gpointer cached;
+    if (g_hash_table_lookup_extended (inlineStorageCache, info, NULL, &cached))
+        return GPOINTER_TO_INT (cached);
+
+    bool result = IsPlainOldData (info);
+    g_hash_table_insert (inlineStorageCache, g_base_info_ref (info), GINT_TO_POINTER (result));
+    return result;
+}
+
 static void BoxedDestroyed(const Nan::WeakCallbackInfo<Boxed> &info);
 
+static const char* GetBoxedCensusGroup(Boxed *box) {
+    if (box->g_type != G_TYPE_NONE)
+        return g_type_name (box->g_type);
+    return g_base_info_get_namespace (box->info);
+}
+
+/*
+ * Makes @self own @boxed: it's freed when the wrapper is collected
+ */
+static void AdoptBoxed(Local<Object> self, GIBaseInfo *gi_info, GType gtype, void *boxed, unsigned long size) {
+    auto* box = new Boxed();
+    box->data = boxed;
+    box->size = size;
+    box->g_type = gtype;
+    box->info = g_base_info_ref (gi_info);
+    box->persistent = new Nan::Persistent<Object>(self);
+    box->persistent->SetWeak(box, BoxedDestroyed, Nan::WeakCallbackType::kParameter);
+
+    /* Let the GC know about the memory the wrapper keeps alive. Only owning
+     * wrappers get here: views (of an object, a parent struct or a region)
+     * & inline storage are charged to whatever owns their memory. */
+    if (size == 0) {
+        GIInfoType info_type = g_base_info_get_type (gi_info);
+        if (info_type == GI_INFO_TYPE_STRUCT || info_type == GI_INFO_TYPE_UNION)
+            size = Boxed::GetSize (gi_info);
+    }
+    box->external_size = EstimateBoxedSize (gtype, boxed, size);
+    AdjustExternalMemory (box->external_size);
+
+    HeapGraphAddBoxed (box);
+    CensusAdd (CENSUS_BOXED, GetBoxedCensusGroup (box), box->external_size);
+}
+
+/*
+ * Borrowed views of memory owned by a GObject (eg. the path returned by
+ * gtk_widget_get_path()) keep its wrapper alive, but the memory may go away
+ * when the object is disposed: they get a copy of their own then (see
+ * DetachBoxedViews).
+ */
+
+struct BoxedView {
+    Nan::Persistent<Object> wrapper;
+    GIBaseInfo *info;
+    GObject *owner;
+};
+
+/* GObject => GSList of BoxedView */
+static GHashTable *viewsByOwner = NULL;
+
+static void BoxedViewFree(BoxedView *view) {
+    view->wrapper.Reset ();
+    g_base_info_unref (view->info);
+    delete view;
+}
+
+static void BoxedViewCollected(const Nan::WeakCallbackInfo<BoxedView> &info) {
+    BoxedView *view = info.GetParameter ();
+
+    GSList *views = (GSList *) g_hash_table_lookup (viewsByOwner, view->owner);
+    views = g_slist_remove (views, view);
+
+    if (views != NULL)
+        g_hash_table_insert (viewsByOwner, view->owner, views);
+    else
+        g_hash_table_remove (viewsByOwner, view->owner);
+
+    BoxedViewFree (view);
+}
+
+static void TrackBoxedView(Local<Object> self, GIBaseInfo *gi_info, GObject *owner) {
+    if (viewsByOwner == NULL)
+        viewsByOwner = g_hash_table_new (NULL, NULL);
+
+    auto *view = new BoxedView ();
+    view->wrapper.Reset (self);
+    view->wrapper.SetWeak (view, BoxedViewCollected, Nan::WeakCallbackType::kParameter);
+    view->info = g_base_info_ref (gi_info);
+    view->owner = owner;
+
+    GSList *views = (GSList *) g_hash_table_lookup (viewsByOwner, owner);
+    g_hash_table_insert (viewsByOwner, owner, g_slist_prepend (views, view));
+}
+
+/*
+ * Gives @self a copy of the memory it borrows, or invalidates it if the type
+ * can't be copied (accesses throw instead of touching freed memory).
+ */
+static void DetachBoxedView(Local<Object> self, GIBaseInfo *gi_info) {
+    void *data = self->GetAlignedPointerFromInternalField (0);
+    GType gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) gi_info);
+    GIInfoType info_type = g_base_info_get_type (gi_info);
+    unsigned long size = 0;
+    void *copy = NULL;
+
+    if (data != NULL) {
+        if (gtype == G_TYPE_VARIANT)
+            copy = g_variant_ref_sink ((GVariant *) data);
+        else if (G_TYPE_IS_BOXED (gtype))
+            copy = g_boxed_copy (gtype, data);
+        else if ((info_type == GI_INFO_TYPE_STRUCT || info_type == GI_INFO_TYPE_UNION)
+                && (size = Boxed::GetSize (gi_info)) != 0)
+            copy = g_slice_copy (size, data);
+    }
+
+    Nan::DeletePrivate (self, UTF8("__owner__"));
+    self->SetAlignedPointerInInternalField (0, copy);
+
+    if (copy != NULL)
+        AdoptBoxed (self, gi_info, gtype, copy, size);
+}
+
+/**
+ * Detaches the borrowed views of @gobject's memory, before it's disposed
+ */
+void DetachBoxedViews(GObject *gobject) {
+    if (viewsByOwner == NULL)
+        return;
+
+    GSList *views = (GSList *) g_hash_table_lookup (viewsByOwner, gobject);
+    if (views == NULL)
+        return;
+
+    g_hash_table_remove (viewsByOwner, gobject);
+
+    Nan::HandleScope scope;
+
+    for (GSList *l = views; l != NULL; l = l->next) {
+        BoxedView *view = (BoxedView *) l->data;
+        DetachBoxedView (Nan::New (view->wrapper), view->info);
+        BoxedViewFree (view);
+    }
+
+    g_slist_free (views);
+}
+
 static void BoxedConstructor(const Nan::FunctionCallbackInfo<Value> &info) {
     /* See gobject.cc for how this works */
     if (!info.IsConstructCall ()) {
@@ -146,6 +374,9 @@ static void BoxedConstructor(const Nan::FunctionCallbackInfo<Value> &info) {
 
     void *boxed = NULL;
     unsigned long size = 0;
+    bool needs_free = true;
+    bool in_region = false;
+    GObject *owner_gobject = NULL;
 
     Local<Object> self = info.This ();
     GIBaseInfo *gi_info = (GIBaseInfo *) External::Cast (*info.Data ())->Value ();
@@ -156,6 +387,29 @@ static void BoxedConstructor(const Nan::FunctionCallbackInfo<Value> &info) {
 
         boxed = External::Cast(*info[0])->Value();
 
+        if (info[1]->IsObject ()) {
+            /* Borrowed: @boxed points into the memory of the owner, which
+             * we keep alive. Nothing to free. */
+            Nan::SetPrivate (self, UTF8("__owner__"), info[1]);
+            needs_free = false;
+
+            if (ValueIsGObject (info[1]))
+                owner_gobject = GObjectFromWrapper (info[1]);
+        } else if (info[1]->IsFalse ()) {
+            /* Not owned, and nothing to tie its lifetime to */
+            needs_free = false;
+        }
+
+        /* Slice-allocated copy, see WrapperFromBoxed */
+        if (info[2]->IsNumber ())
+            size = Nan::To<uint32_t> (info[2]).ToChecked ();
+
+        /* Caller-allocated arguments & views of region memory */
+        if (RegionContains (boxed)) {
+            in_region = true;
+            needs_free = false;
+        }
+
     } else {
         /* User code calling `new Pango.AttrList()` */
 
@@ -185,7 +439,18 @@ static void BoxedConstructor(const Nan::FunctionCallbackInfo<Value> &info) {
             boxed = return_value.v_pointer;
 
         } else if ((size = Boxed::GetSize(gi_info)) != 0) {
-            boxed = g_slice_alloc0(size);
+            if ((boxed = RegionAlloc (size)) != NULL) {
+                in_region = true;
+                needs_free = false;
+            } else if (UseInlineStorage (gi_info, size)) {
+                /* The GC reclaims the storage with the wrapper, no weak callback needed */
+                auto storage = v8::ArrayBuffer::New (Isolate::GetCurrent (), size);
+                Nan::SetPrivate (self, UTF8("__storage__"), storage);
+                boxed = Util::GetArrayBufferData (storage);
+                needs_free = false;
+            } else {
+                boxed = g_slice_alloc0(size);
+            }
 
         } else {
             Nan::ThrowError("Boxed allocation failed: no constructor found");
@@ -198,6 +463,12 @@ static void BoxedConstructor(const Nan::FunctionCallbackInfo<Value> &info) {
         }
     }
 
+    /* GVariant is not a boxed type: we adopt a plain reference instead. A
+     * floating one is sunk, a full one is taken as is (see WrapperFromBoxed
+     * for borrowed ones). */
+    if (gtype == G_TYPE_VARIANT && needs_free)
+        g_variant_take_ref ((GVariant *) boxed);
+
     self->SetAlignedPointerInInternalField (0, boxed);
 
     Nan::DefineOwnProperty(self,
@@ -206,21 +477,31 @@ static void BoxedConstructor(const Nan::FunctionCallbackInfo<Value> &info) {
             (v8::PropertyAttribute)(v8::PropertyAttribute::ReadOnly | v8::PropertyAttribute::DontEnum)
     );
 
-    auto* box = new Boxed();
-    box->data = boxed;
-    box->size = size;
-    box->g_type = gtype;
-    box->info = g_base_info_ref (gi_info);
-    box->persistent = new Nan::Persistent<Object>(self);
-    box->persistent->SetWeak(box, BoxedDestroyed, Nan::WeakCallbackType::kParameter);
+    if (in_region)
+        RegionTrack (self, boxed);
+
+    if (owner_gobject != NULL)
+        TrackBoxedView (self, gi_info, owner_gobject);
+
+    if (!needs_free)
+        return;
+
+    AdoptBoxed (self, gi_info, gtype, boxed, size);
 }
 
-static void BoxedDestroyed(const Nan::WeakCallbackInfo<Boxed> &info) {
-    Boxed *box = info.GetParameter();
+/*
+ * Frees the memory of a collected wrapper. Deferred out of the GC
+ * (see finalization.cc)
+ */
+static void ReleaseBoxed(gpointer data) {
+    Boxed *box = (Boxed *) data;
 
     if (G_TYPE_IS_BOXED(box->g_type)) {
         g_boxed_free(box->g_type, box->data);
     }
+    else if (box->g_type == G_TYPE_VARIANT) {
+        g_variant_unref((GVariant *) box->data);
+    }
     else if (box->size != 0) {
         // Allocated in ./function.cc @ AllocateArgument
         g_slice_free1(box->size, box->data);
@@ -236,10 +517,22 @@ static void BoxedDestroyed(const Nan::WeakCallbackInfo<Boxed> &info) {
     }
 
     g_base_info_unref (box->info);
-    delete box->persistent;
     delete box;
 }
 
+static void BoxedDestroyed(const Nan::WeakCallbackInfo<Boxed> &info) {
+    Boxed *box = info.GetParameter();
+
+    delete box->persistent;
+    box->persistent = NULL;
+
+    AdjustExternalMemory (-(gint64) box->external_size);
+    HeapGraphRemoveBoxed (box);
+    CensusRemove (CENSUS_BOXED, GetBoxedCensusGroup (box), box->external_size);
+
+    QueueFinalization (ReleaseBoxed, box);
+}
+
 static void BoxedClassDestroyed(const v8::WeakCallbackInfo<GIBaseInfo> &info) {
     GIBaseInfo *gi_info = info.GetParameter ();
     GType gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) gi_info);
@@ -367,16 +660,19 @@ Local<Function> MakeBoxedClass(GIBaseInfo *info) {
     return GetBoxedFunction (info, gtype);
 }
 
-Local<Value> WrapperFromBoxed(GIBaseInfo *info, void *data) {
+static Local<Value> NewBoxedWrapper (GIBaseInfo *info, void *data, Local<Value> owner, unsigned long size) {
     if (data == NULL)
         return Nan::Null();
 
     Local<Function> constructor = MakeBoxedClass (info);
 
-    Local<Value> boxed_external = Nan::New<External> (data);
-    Local<Value> args[] = { boxed_external };
+    Local<Value> args[] = {
+        Nan::New<External> (data),
+        owner,
+        size != 0 ? Local<Value> (Nan::New<Number> (size)) : Local<Value> (Nan::Undefined ()),
+    };
 
-    MaybeLocal<Object> instance = Nan::NewInstance(constructor, 1, args);
+    MaybeLocal<Object> instance = Nan::NewInstance(constructor, G_N_ELEMENTS (args), args);
 
     // FIXME(we should propage failure here)
     if (instance.IsEmpty())
@@ -385,6 +681,322 @@ Local<Value> WrapperFromBoxed(GIBaseInfo *info, void *data) {
     return instance.ToLocalChecked();
 }
 
+/**
+ * Wraps a boxed, and adopts it
+ */
+Local<Value> WrapperFromBoxed(GIBaseInfo *info, void *data) {
+    return NewBoxedWrapper (info, data, Nan::Undefined (), 0);
+}
+
+/**
+ * Wraps a boxed. If @owner is given, the wrapper borrows @data: it doesn't
+ * free it, and keeps @owner (which owns the memory) alive.
+ */
+Local<Value> WrapperFromBoxed(GIBaseInfo *info, void *data, Local<Object> owner) {
+    if (owner.IsEmpty ())
+        return WrapperFromBoxed (info, data);
+    return NewBoxedWrapper (info, data, owner, 0);
+}
+
+/**
+ * Wraps a boxed according to its ownership transfer:
+ *  - transferred values are adopted
+ *  - borrowed boxed types & variants are copied (or ref'd): their owner may
+ *    free or replace them at any time (eg. gtk_widget_get_path's cache)
+ *  - borrowed plain structs with an @owner become views that keep @owner
+ *    alive, and are copied if it's disposed (see DetachBoxedViews)
+ *  - other borrowed plain structs are copied
+ */
+Local<Value> WrapperFromBoxed(GIBaseInfo *info, void *data, GITransfer transfer, Local<Object> owner) {
+    if (data == NULL)
+        return Nan::Null();
+
+    if (transfer != GI_TRANSFER_NOTHING || RegionContains (data))
+        return WrapperFromBoxed (info, data);
+
+    GType gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) info);
+
+    /* The wrapper takes its own reference */
+    if (gtype == G_TYPE_VARIANT)
+        return WrapperFromBoxed (info, g_variant_ref_sink ((GVariant *) data));
+
+    if (G_TYPE_IS_BOXED (gtype))
+        return WrapperFromBoxed (info, g_boxed_copy (gtype, data));
+
+    if (!owner.IsEmpty ())
+        return NewBoxedWrapper (info, data, owner, 0);
+
+    unsigned long size = Boxed::GetSize (info);
+    if (size != 0)
+        return NewBoxedWrapper (info, g_slice_copy (size, data), Nan::Undefined (), size);
+
+    return NewBoxedWrapper (info, data, Nan::False (), 0);
+}
+
+/*
+ * Struct fields of scalar types get native accessors: the offset and the
+ * storage type are resolved once, and each access is a direct load/store.
+ */
+
+struct FieldAccessor {
+    gsize       offset;
+    GITypeTag   tag;
+    GIBaseInfo *info; /* For BigInt mode lookups, or the struct info of nested structs */
+    Nan::Persistent<External> data; /* Weak: freed with the prototype holding it */
+};
+
+static void FieldAccessorDestroyed (const Nan::WeakCallbackInfo<FieldAccessor> &info) {
+    FieldAccessor *accessor = info.GetParameter ();
+    accessor->data.Reset ();
+    g_base_info_unref (accessor->info);
+    delete accessor;
+}
+
+/**
+ * @returns the struct/union info if the field is an inline struct or union,
+ *     NULL otherwise
+ */
+GIBaseInfo *GetNestedStructInfo (GIFieldInfo *field) {
+    GITypeInfo *type_info = g_field_info_get_type (field);
+    GIBaseInfo *result = NULL;
+
+    if (g_type_info_get_tag (type_info) == GI_TYPE_TAG_INTERFACE && !g_type_info_is_pointer (type_info)) {
+        GIBaseInfo *interface_info = g_type_info_get_interface (type_info);
+        GIInfoType interface_type = g_base_info_get_type (interface_info);
+
+        if (interface_type == GI_INFO_TYPE_STRUCT || interface_type == GI_INFO_TYPE_UNION)
+            result = g_base_info_ref (interface_info);
+
+        g_base_info_unref (interface_info);
+    }
+
+    g_base_info_unref (type_info);
+    return result;
+}
+
+/**
+ * Gets the storage type of a scalar (non-pointer) field
+ * @param field the field info
+ * @param tag (out) the storage type tag (enums & flags resolve to their storage type)
+ * @returns false if the field isn't a scalar
+ */
+bool GetFieldStorageTag (GIFieldInfo *field, GITypeTag *tag) {
+    GITypeInfo *type_info = g_field_info_get_type (field);
+    bool is_scalar = false;
+
+    /* Bitfields have a non-zero size in bits, and are left to g_field_info_get_field */
+    if (!g_type_info_is_pointer (type_info) && g_field_info_get_size (field) == 0) {
+        *tag = g_type_info_get_tag (type_info);
+
+        if (*tag == GI_TYPE_TAG_INTERFACE) {
+            GIBaseInfo *interface_info = g_type_info_get_interface (type_info);
+            GIInfoType interface_type = g_base_info_get_type (interface_info);
+
+            if (interface_type == GI_INFO_TYPE_ENUM || interface_type == GI_INFO_TYPE_FLAGS) {
+                *tag = g_enum_info_get_storage_type ((GIEnumInfo *) interface_info);
+                is_scalar = true;
+            }
+
+            g_base_info_unref (interface_info);
+        } else {
+            is_scalar = G_TYPE_TAG_IS_BASIC (*tag)
+                && *tag != GI_TYPE_TAG_VOID
+                && *tag != GI_TYPE_TAG_UNICHAR
+                && *tag != GI_TYPE_TAG_UTF8
+                && *tag != GI_TYPE_TAG_FILENAME;
+        }
+    }
+
+    g_base_info_unref (type_info);
+    return is_scalar;
+}
+
+static void *GetFieldAddress (Local<Object> self, FieldAccessor *accessor) {
+    if (self->InternalFieldCount () == 0) {
+        Nan::ThrowTypeError ("Field accessed on an object that is not a boxed");
+        return NULL;
+    }
+
+    void *boxed = self->GetAlignedPointerFromInternalField (0);
+    if (boxed == NULL) {
+        Nan::ThrowError ("Boxed has been released (used outside of its region?)");
+        return NULL;
+    }
+
+    return (guint8 *) boxed + accessor->offset;
+}
+
+static NAN_GETTER(FieldGetter) {
+    auto *accessor = (FieldAccessor *) External::Cast (*info.Data ())->Value ();
+    void *address = GetFieldAddress (info.This (), accessor);
+
+    if (address == NULL)
+        return;
+
+    switch (accessor->tag) {
+        case GI_TYPE_TAG_INTERFACE:
+            /* Nested struct: a view into the parent's memory */
+            RETURN (WrapperFromBoxed (accessor->info, address, info.This ()));
+            break;
+        case GI_TYPE_TAG_BOOLEAN:
+            RETURN (Nan::New<v8::Boolean> (*(gboolean *) address != FALSE));
+            break;
+        case GI_TYPE_TAG_INT8:
+            RETURN (*(gint8 *) address);
+            break;
+        case GI_TYPE_TAG_UINT8:
+            RETURN (*(guint8 *) address);
+            break;
+        case GI_TYPE_TAG_INT16:
+            RETURN (*(gint16 *) address);
+            break;
+        case GI_TYPE_TAG_UINT16:
+            RETURN (*(guint16 *) address);
+            break;
+        case GI_TYPE_TAG_INT32:
+            RETURN (*(gint32 *) address);
+            break;
+        case GI_TYPE_TAG_UINT32:
+            RETURN (*(guint32 *) address);
+            break;
+        case GI_TYPE_TAG_INT64:
+            RETURN (Int64ToV8 (*(gint64 *) address, UseBigInt (accessor->info)));
+            break;
+        case GI_TYPE_TAG_UINT64:
+            RETURN (Uint64ToV8 (*(guint64 *) address, UseBigInt (accessor->info)));
+            break;
+        case GI_TYPE_TAG_GTYPE:
+            RETURN (Uint64ToV8 (*(GType *) address, UseBigInt (accessor->info)));
+            break;
+        case GI_TYPE_TAG_FLOAT:
+            RETURN (*(gfloat *) address);
+            break;
+        case GI_TYPE_TAG_DOUBLE:
+            RETURN (*(gdouble *) address);
+            break;
+        default:
+            g_assert_not_reached ();
+    }
+}
+
+static NAN_SETTER(FieldSetter) {
+    auto *accessor = (FieldAccessor *) External::Cast (*info.Data ())->Value ();
+    void *address = GetFieldAddress (info.This (), accessor);
+
+    if (address == NULL)
+        return;
+
+    switch (accessor->tag) {
+        case GI_TYPE_TAG_INTERFACE:
+        {
+            GType gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) accessor->info);
+            bool is_instance = gtype != G_TYPE_NONE ?
+                ValueIsInstanceOfGType (value, gtype) :
+                ValueHasInternalField (value);
+
+            if (!is_instance || BoxedFromWrapper (value) == NULL) {
+                Nan::ThrowTypeError ("Value is not an instance of the field type");
+                break;
+            }
+
+            memmove (address, BoxedFromWrapper (value), Boxed::GetSize (accessor->info));
+            break;
+        }
+        case GI_TYPE_TAG_BOOLEAN:
+            *(gboolean *) address = Nan::To<bool> (value).ToChecked ();
+            break;
+        case GI_TYPE_TAG_INT8:
+            *(gint8 *) address = Nan::To<int32_t> (value).ToChecked ();
+            break;
+        case GI_TYPE_TAG_UINT8:
+            *(guint8 *) address = Nan::To<uint32_t> (value).ToChecked ();
+            break;
+        case GI_TYPE_TAG_INT16:
+            *(gint16 *) address = Nan::To<int32_t> (value).ToChecked ();
+            break;
+        case GI_TYPE_TAG_UINT16:
+            *(guint16 *) address = Nan::To<uint32_t> (value).ToChecked ();
+            break;
+        case GI_TYPE_TAG_INT32:
+            *(gint32 *) address = Nan::To<int32_t> (value).ToChecked ();
+            break;
+        case GI_TYPE_TAG_UINT32:
+            *(guint32 *) address = Nan::To<uint32_t> (value).ToChecked ();
+            break;
+        case GI_TYPE_TAG_INT64:
+            if (!V8ToInt64 (value, (gint64 *) address))
+                Nan::ThrowRangeError ("Value out of range for a 64-bit integer");
+            break;
+        case GI_TYPE_TAG_UINT64:
+            if (!V8ToUint64 (value, (guint64 *) address))
+                Nan::ThrowRangeError ("Value out of range for an unsigned 64-bit integer");
+            break;
+        case GI_TYPE_TAG_GTYPE:
+        {
+            guint64 gtype;
+            if (!V8ToUint64 (value, &gtype))
+                Nan::ThrowRangeError ("Value out of range for a GType");
+            else
+                *(GType *) address = gtype;
+            break;
+        }
+        case GI_TYPE_TAG_FLOAT:
+            *(gfloat *) address = Nan::To<double> (value).ToChecked ();
+            break;
+        case GI_TYPE_TAG_DOUBLE:
+            *(gdouble *) address = Nan::To<double> (value).ToChecked ();
+            break;
+        default:
+            g_assert_not_reached ();
+    }
+}
+
+/**
+ * Defines a native accessor for a struct/union field
+ * @param prototype the prototype of the boxed class
+ * @param field the field info
+ * @param name the JS name of the field
+ * @returns false if the field isn't a scalar or a nested struct, in which
+ *     case nothing is defined
+ */
+bool DefineStructField (Local<Object> prototype, GIFieldInfo *field, Local<String> name) {
+    GITypeTag tag;
+    GIBaseInfo *nested_info = NULL;
+
+    if (GetFieldStorageTag (field, &tag))
+        nested_info = g_base_info_ref (field);
+    else if ((nested_info = GetNestedStructInfo (field)) != NULL)
+        tag = GI_TYPE_TAG_INTERFACE;
+    else
+        return false;
+
+    GIFieldInfoFlags flags = g_field_info_get_flags (field);
+    bool readable = (flags & GI_FIELD_IS_READABLE) != 0;
+    bool writable = (flags & GI_FIELD_IS_WRITABLE) != 0;
+
+    /* Left to the JS accessors, which don't define a getter */
+    if (!readable) {
+        g_base_info_unref (nested_info);
+        return false;
+    }
+
+    auto *accessor = new FieldAccessor ();
+    accessor->offset = g_field_info_get_offset (field);
+    accessor->tag    = tag;
+    accessor->info   = nested_info;
+
+    Local<External> data = Nan::New<External> (accessor);
+    accessor->data.Reset (data);
+    accessor->data.SetWeak (accessor, FieldAccessorDestroyed, Nan::WeakCallbackType::kParameter);
+
+    return Nan::SetAccessor (prototype, name,
+            FieldGetter,
+            writable ? FieldSetter : NULL,
+            data,
+            v8::DEFAULT,
+            writable ? v8::None : v8::ReadOnly);
+}
+
 void* BoxedFromWrapper(Local<Value> value) {
     Local<Object> object = TO_OBJECT (value);
     g_assert(object->InternalFieldCount() > 0);
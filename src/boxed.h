@@ -22,6 +22,7 @@ public:
     GType g_type;
     GIBaseInfo * info;
     unsigned long size;
+    gsize external_size;
     Nan::Persistent<Object> *persistent;
 
     static size_t GetSize (GIBaseInfo *boxed_info) ;
@@ -30,6 +31,12 @@ public:
 Local<Function>         MakeBoxedClass   (GIBaseInfo *info);
 Local<FunctionTemplate> GetBoxedTemplate (GIBaseInfo *info, GType gtype);
 Local<Value>            WrapperFromBoxed (GIBaseInfo *info, void *data);
+Local<Value>            WrapperFromBoxed (GIBaseInfo *info, void *data, Local<Object> owner);
+Local<Value>            WrapperFromBoxed (GIBaseInfo *info, void *data, GITransfer transfer, Local<Object> owner);
 void *                  BoxedFromWrapper (Local<Value>);
+bool                    DefineStructField (Local<Object> prototype, GIFieldInfo *field, Local<String> name);
+bool                    GetFieldStorageTag (GIFieldInfo *field, GITypeTag *tag);
+GIBaseInfo *            GetNestedStructInfo (GIFieldInfo *field);
+void                    DetachBoxedViews (GObject *gobject);
 
 };
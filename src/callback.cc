@@ -1,10 +1,13 @@
 #include <glib.h>
 #include <nan.h>
+#include <string.h>
 
 #include "callback.h"
+#include "census.h"
 #include "closure.h"
 #include "debug.h"
 #include "error.h"
+#include "heap_graph.h"
 #include "loop.h"
 #include "type.h"
 #include "value.h"
@@ -24,19 +27,156 @@ namespace GNodeJS {
 static unsigned int callbackLevel = 0;
 
 static GSList* notifiedCallbacks = NULL;
+static guint   notifiedCount = 0;
 
 
-Callback::Callback(Local<Function> fn, GICallableInfo* callback_info, GIArgInfo* arg_info) {
-    persistent.Reset(fn);
-    info = g_base_info_ref (callback_info);
-    closure = g_callable_info_prepare_closure(info, &cif, Callback::Call, this);
-    scope_type = g_arg_info_get_scope (arg_info);
+/* Calls with up to this many arguments don't allocate their JS arguments */
+#define CALLBACK_SMALL_ARITY 8
+
+
+CallbackPlan::CallbackPlan(GICallableInfo *info) {
+    n_args = g_callable_info_get_n_args (info);
+    args = new CallbackArg[n_args];
+
+    for (int i = 0; i < n_args; i++) {
+        GIArgInfo *arg_info = g_callable_info_get_arg (info, i);
+        args[i].type_info = g_arg_info_get_type (arg_info);
+        args[i].transfer = g_arg_info_get_ownership_transfer (arg_info);
+        g_base_info_unref (arg_info);
+    }
+
+    return_type = g_callable_info_get_return_type (info);
+    return_tag = GetStorageType (return_type);
+    return_transfer = g_callable_info_get_caller_owns (info);
+    may_return_null = g_callable_info_may_return_null (info);
+}
+
+CallbackPlan::~CallbackPlan() {
+    for (int i = 0; i < n_args; i++)
+        g_base_info_unref (args[i].type_info);
+    delete[] args;
+    g_base_info_unref (return_type);
+}
+
+
+/*
+ * What callbacks of the same type share: the cif, the argument types and a
+ * free list of released callbacks.
+ */
+struct CallbackType {
+    GICallableInfo *info;
+    ffi_cif cif;
+    ffi_type **atypes;
+    CallbackPlan *plan;
+    GSList *free_list;
+    guint n_free;
+};
+
+/* Released callbacks kept per type */
+#define CALLBACK_POOL_SIZE 16
+
+/* Qualified name -> CallbackType */
+static GHashTable *callbackTypes = NULL;
+
+static CallbackType* GetCallbackType (GICallableInfo *info) {
+    if (G_UNLIKELY (callbackTypes == NULL))
+        callbackTypes = g_hash_table_new (g_str_hash, g_str_equal);
+
+    char *name = GetInfoName (info);
+    auto *type = (CallbackType *) g_hash_table_lookup (callbackTypes, name);
+
+    if (type != NULL) {
+        g_free (name);
+        return type;
+    }
+
+    int n_args;
+    type = g_new0 (CallbackType, 1);
+    type->info = g_base_info_ref (info);
+    type->atypes = g_callable_info_get_ffi_arg_types (info, &n_args);
+    ffi_prep_cif (&type->cif, FFI_DEFAULT_ABI, n_args,
+            g_callable_info_get_ffi_return_type (info), type->atypes);
+    type->plan = new CallbackPlan (info);
+
+    /* Owns @name */
+    g_hash_table_insert (callbackTypes, name, type);
+
+    return type;
+}
+
+Callback::Callback(CallbackType *callback_type) {
+    type = callback_type;
+    info = g_base_info_ref (type->info);
+    plan = type->plan;
+    closure = (ffi_closure *) ffi_closure_alloc (sizeof (ffi_closure), &code);
+    if (closure != NULL)
+        ffi_prep_closure_loc (closure, &type->cif, Callback::Call, this, code);
 }
 
 Callback::~Callback() {
     persistent.Reset();
-    g_callable_info_free_closure (this->info, this->closure);
-    g_base_info_unref (this->info);
+    if (closure != NULL)
+        ffi_closure_free (closure);
+    g_base_info_unref (info);
+}
+
+/**
+ * Returns a callback calling @function, reusing a released one if possible.
+ * Throws and returns NULL if no closure could be allocated.
+ */
+Callback* Callback::Acquire (Local<Function> function, GICallableInfo* callback_info, GIArgInfo* arg_info) {
+    CallbackType *type = GetCallbackType (callback_info);
+    Callback *callback;
+
+    if (type->free_list != NULL) {
+        callback = (Callback *) type->free_list->data;
+        type->free_list = g_slist_delete_link (type->free_list, type->free_list);
+        type->n_free--;
+    } else {
+        callback = new Callback (type);
+
+        if (callback->closure == NULL) {
+            delete callback;
+            char *message = g_strdup_printf ("Could not allocate a closure for callback %s",
+                    g_base_info_get_name (callback_info));
+            Nan::ThrowError (message);
+            g_free (message);
+            return NULL;
+        }
+    }
+
+    callback->persistent.Reset (function);
+    callback->scope_type = g_arg_info_get_scope (arg_info);
+
+    HeapGraphAddCallback (callback);
+    CensusAdd (CENSUS_CALLBACK, g_base_info_get_namespace (callback->info), sizeof (Callback));
+
+    return callback;
+}
+
+/**
+ * Returns @callback to the pool of its type, once C code can't call it anymore.
+ *
+ * Only call-scoped callbacks are pooled: a reused closure calls its new
+ * function, so C code still holding an async or notified one (eg. calling an
+ * async callback twice) would silently call someone else's function. Freed,
+ * it crashes instead, as it did before pooling. A call-scoped closure kept by
+ * C past its call (a wrong annotation) has the same hazard.
+ */
+void Callback::Release (Callback *callback) {
+    HeapGraphRemoveCallback (callback);
+    CensusRemove (CENSUS_CALLBACK, g_base_info_get_namespace (callback->info), sizeof (Callback));
+
+    callback->persistent.Reset ();
+
+    CallbackType *type = callback->type;
+
+    if (callback->scope_type == GI_SCOPE_TYPE_CALL && type->n_free < CALLBACK_POOL_SIZE) {
+        type->free_list = g_slist_prepend (type->free_list, callback);
+        type->n_free++;
+    } else {
+        delete callback;
+    }
 }
 
 
@@ -46,6 +186,7 @@ Callback::~Callback() {
  */
 void Callback::DestroyNotify (void* user_data) {
     notifiedCallbacks = g_slist_prepend (notifiedCallbacks, user_data);
+    notifiedCount++;
 }
 
 /**
@@ -59,12 +200,69 @@ void Callback::AsyncFree () {
 
     while (current != NULL) {
         Callback* callback = static_cast<Callback*>(current->data);
-        delete callback;
+        Callback::Release (callback);
 
         current = current->next;
     }
 
     notifiedCallbacks = NULL;
+    notifiedCount = 0;
+}
+
+/**
+ * Number of callbacks destroy-notified but not freed yet
+ */
+guint Callback::GetPendingCount () {
+    return notifiedCount;
+}
+
+/*
+ * Stores a converted return value in the libffi return buffer, where
+ * integers smaller than a register are widened to ffi_arg.
+ */
+static void StoreReturnValue (GITypeTag tag, GIArgument *arg, void *result) {
+    switch (tag) {
+        case GI_TYPE_TAG_BOOLEAN:
+            *(ffi_sarg *) result = arg->v_boolean;
+            break;
+        case GI_TYPE_TAG_INT8:
+            *(ffi_sarg *) result = arg->v_int8;
+            break;
+        case GI_TYPE_TAG_INT16:
+            *(ffi_sarg *) result = arg->v_int16;
+            break;
+        case GI_TYPE_TAG_INT32:
+            *(ffi_sarg *) result = arg->v_int32;
+            break;
+        case GI_TYPE_TAG_UINT8:
+            *(ffi_arg *) result = arg->v_uint8;
+            break;
+        case GI_TYPE_TAG_UINT16:
+            *(ffi_arg *) result = arg->v_uint16;
+            break;
+        case GI_TYPE_TAG_UINT32:
+        case GI_TYPE_TAG_UNICHAR:
+            *(ffi_arg *) result = arg->v_uint32;
+            break;
+        case GI_TYPE_TAG_INT64:
+            *(gint64 *) result = arg->v_int64;
+            break;
+        case GI_TYPE_TAG_UINT64:
+            *(guint64 *) result = arg->v_uint64;
+            break;
+        case GI_TYPE_TAG_GTYPE:
+            *(GType *) result = arg->v_size;
+            break;
+        case GI_TYPE_TAG_FLOAT:
+            *(gfloat *) result = arg->v_float;
+            break;
+        case GI_TYPE_TAG_DOUBLE:
+            *(gdouble *) result = arg->v_double;
+            break;
+        default:
+            *(gpointer *) result = arg->v_pointer;
+            break;
+    }
 }
 
 /**
@@ -72,52 +270,62 @@ void Callback::AsyncFree () {
  */
 void Callback::Call (ffi_cif *cif, void *result, void **args, gpointer user_data) {
     Callback *callback = static_cast<Callback *>(user_data);
+    CallbackPlan *plan = callback->plan;
 
-    int n_native_args = g_callable_info_get_n_args(callback->info);
-
-    #ifndef __linux__
-        Local<Value>* js_args = new Local<Value>[n_native_args];
-    #else
-        Local<Value> js_args[n_native_args];
-    #endif
-
-    GIArgument **gi_args = reinterpret_cast<GIArgument **>(args);
-
-    for (int i = 0; i < n_native_args; i++) {
-        GIArgInfo arg_info;
-        GITypeInfo arg_type;
-        g_callable_info_load_arg (callback->info, i, &arg_info);
-        g_arg_info_load_type (&arg_info, &arg_type);
-
-        js_args[i] = GIArgumentToV8 (&arg_type, gi_args[i]);
+    /* Released (see Callback::Release): C code kept it past its scope */
+    if (G_UNLIKELY (callback->persistent.IsEmpty ())) {
+        warn ("callback %s called after its scope ended", g_base_info_get_name (callback->info));
+        memset (result, 0, MAX (cif->rtype->size, sizeof (ffi_arg)));
+        return;
     }
 
-    Local<Function> function = Nan::New<Function>(callback->persistent);
-    Local<Object> self = Nan::GetCurrentContext()->Global();
-
     Isolate *isolate = Isolate::GetCurrent ();
     HandleScope scope(isolate);
-    Local<Context> context = Context::New(isolate);
+
+    Local<Function> function = Nan::New<Function>(callback->persistent);
+
+    /* Synchronous callbacks run in the context of their caller, the ones
+     * called from the loop in the context of their function */
+    Local<Context> context = isolate->InContext ()
+        ? isolate->GetCurrentContext ()
+        : function->CreationContext ();
     Context::Scope context_scope(context);
     Nan::TryCatch try_catch;
 
+    int n_native_args = plan->n_args;
+
+    Local<Value> small_args[CALLBACK_SMALL_ARITY];
+    Local<Value> *js_args = n_native_args <= CALLBACK_SMALL_ARITY
+        ? small_args
+        : new Local<Value>[n_native_args];
+
+    GIArgument **gi_args = reinterpret_cast<GIArgument **>(args);
+
+    for (int i = 0; i < n_native_args; i++)
+        js_args[i] = GIArgumentToV8 (plan->args[i].type_info, gi_args[i], -1, plan->args[i].transfer);
+
+    Local<Object> self = context->Global();
+
     callbackLevel++;
     auto return_value = Nan::Call(function, self, n_native_args, js_args);
     callbackLevel--;
 
-    if (!return_value.IsEmpty()) {
-        GITypeInfo type_info;
-        g_callable_info_load_return_type (callback->info, &type_info);
+    if (!return_value.IsEmpty()
+            && (plan->return_tag != GI_TYPE_TAG_VOID || g_type_info_is_pointer (plan->return_type))) {
+        GIArgument arg;
 
         bool didConvert = V8ToGIArgument (
-                &type_info,
-                (GIArgument *) &result,
+                plan->return_type,
+                &arg,
                 return_value.ToLocalChecked(),
-                g_callable_info_may_return_null (callback->info));
+                plan->may_return_null);
 
-        if (!didConvert) {
-            Throw::InvalidReturnValue (&type_info, return_value.ToLocalChecked());
+        if (didConvert) {
+            RefTransferredGObject (plan->return_type, &arg, plan->return_transfer);
+            StoreReturnValue (plan->return_tag, &arg, result);
         }
+        else
+            Throw::InvalidReturnValue (plan->return_type, return_value.ToLocalChecked());
     }
 
     if (try_catch.HasCaught()) {
@@ -125,12 +333,11 @@ void Callback::Call (ffi_cif *cif, void *result, void **args, gpointer user_data
         try_catch.ReThrow();
     }
 
-    #ifndef __linux__
+    if (js_args != small_args)
         delete[] js_args;
-    #endif
 
     if (callback->scope_type == GI_SCOPE_TYPE_ASYNC) {
-        delete callback;
+        Callback::Release (callback);
     }
 }
 
@@ -13,19 +13,52 @@
 
 namespace GNodeJS {
 
+/*
+ * The types of the arguments & return value of a callback, loaded once
+ * instead of on each call.
+ */
+struct CallbackArg {
+    GITypeInfo *type_info;
+    GITransfer transfer;
+};
+
+struct CallbackPlan {
+    int n_args;
+    CallbackArg *args;
+    GITypeInfo *return_type;
+    GITypeTag return_tag;
+    GITransfer return_transfer;
+    bool may_return_null;
+
+    CallbackPlan(GICallableInfo *info);
+    ~CallbackPlan();
+};
+
+struct CallbackType;
+
+/*
+ * Call-scoped callbacks are pooled per callback type: their ffi closure is
+ * prepared once, and rebound to a new function when reused. Use Acquire/Release instead of
+ * new/delete.
+ */
 struct Callback {
-    ffi_cif cif;
     ffi_closure *closure;
+    void *code;
     Nan::Persistent<Function> persistent;
     GICallableInfo *info;
     GIScopeType scope_type;
     Parameter* call_parameters;
+    CallbackPlan *plan;
+    CallbackType *type;
 
-    Callback(Local<Function> function, GICallableInfo* info, GIArgInfo* arg_info);
+    Callback(CallbackType *type);
     ~Callback();
 
+    static Callback* Acquire (Local<Function> function, GICallableInfo* info, GIArgInfo* arg_info);
+    static void Release (Callback *callback);
     static void DestroyNotify (void* user_data);
     static void AsyncFree ();
+    static guint GetPendingCount ();
     static void Call (ffi_cif *cif, void *result, void **args, gpointer user_data);
 };
 
@@ -0,0 +1,112 @@
+/*
+ * census.cc
+ *
+ * Live counts & estimated native bytes of wrappers, closures, callbacks and
+ * functions, grouped by GType (or namespace, for what has no GType). The
+ * counters are maintained where those are created & destroyed, so taking a
+ * census is cheap enough to be polled.
+ */
+
+#include "callback.h"
+#include "census.h"
+#include "macros.h"
+
+using v8::Local;
+using v8::Number;
+using v8::Object;
+
+namespace GNodeJS {
+
+struct CensusEntry {
+    gint64 count;
+    gint64 bytes;
+};
+
+static const char *kindNames[CENSUS_N_KINDS] = {
+    "gobjects",
+    "boxed",
+    "closures",
+    "callbacks",
+    "functions",
+};
+
+/* group (a static string: type name or namespace) -> CensusEntry */
+static GHashTable *groups[CENSUS_N_KINDS] = { NULL };
+static CensusEntry totals[CENSUS_N_KINDS] = { { 0, 0 } };
+
+/* Closures can be invalidated from other threads */
+G_LOCK_DEFINE_STATIC (census);
+
+static void CensusUpdate (CensusKind kind, const char *group, gint64 count, gint64 bytes) {
+    G_LOCK (census);
+
+    if (G_UNLIKELY (groups[kind] == NULL))
+        groups[kind] = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_free);
+
+    auto *entry = (CensusEntry *) g_hash_table_lookup (groups[kind], group);
+    if (entry == NULL) {
+        entry = g_new0 (CensusEntry, 1);
+        g_hash_table_insert (groups[kind], (gpointer) group, entry);
+    }
+
+    entry->count += count;
+    entry->bytes += bytes;
+    totals[kind].count += count;
+    totals[kind].bytes += bytes;
+
+    if (entry->count == 0)
+        g_hash_table_remove (groups[kind], group);
+
+    G_UNLOCK (census);
+}
+
+void CensusAdd (CensusKind kind, const char *group, gsize bytes) {
+    CensusUpdate (kind, group, 1, bytes);
+}
+
+void CensusRemove (CensusKind kind, const char *group, gsize bytes) {
+    CensusUpdate (kind, group, -1, -(gint64) bytes);
+}
+
+static Local<Object> NewEntry (CensusEntry *entry) {
+    auto result = Nan::New<Object> ();
+    Nan::Set (result, UTF8("count"), Nan::New<Number> ((double) entry->count));
+    Nan::Set (result, UTF8("bytes"), Nan::New<Number> ((double) entry->bytes));
+    return result;
+}
+
+/**
+ * Returns { [kind]: { count, bytes, groups: { [group]: { count, bytes } } } }
+ */
+Local<Object> GetCensus () {
+    auto result = Nan::New<Object> ();
+
+    G_LOCK (census);
+
+    for (int kind = 0; kind < CENSUS_N_KINDS; kind++) {
+        auto kind_result = NewEntry (&totals[kind]);
+        auto kind_groups = Nan::New<Object> ();
+
+        if (groups[kind] != NULL) {
+            GHashTableIter iter;
+            gpointer key, value;
+
+            g_hash_table_iter_init (&iter, groups[kind]);
+            while (g_hash_table_iter_next (&iter, &key, &value))
+                Nan::Set (kind_groups, UTF8((const char *) key), NewEntry ((CensusEntry *) value));
+        }
+
+        Nan::Set (kind_result, UTF8("groups"), kind_groups);
+        Nan::Set (result, UTF8(kindNames[kind]), kind_result);
+    }
+
+    G_UNLOCK (census);
+
+    /* Destroy-notified, waiting for Callback::AsyncFree */
+    auto callbacks = Nan::Get (result, UTF8("callbacks")).ToLocalChecked ().As<Object> ();
+    Nan::Set (callbacks, UTF8("pending"), Nan::New<Number> (Callback::GetPendingCount ()));
+
+    return result;
+}
+
+};
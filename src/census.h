@@ -0,0 +1,24 @@
+
+#pragma once
+
+#include <nan.h>
+#include <glib.h>
+
+namespace GNodeJS {
+
+  enum CensusKind {
+      CENSUS_GOBJECT,
+      CENSUS_BOXED,
+      CENSUS_CLOSURE,
+      CENSUS_CALLBACK,
+      CENSUS_FUNCTION,
+      CENSUS_N_KINDS
+  };
+
+  void  CensusAdd (CensusKind kind, const char *group, gsize bytes);
+
+  void  CensusRemove (CensusKind kind, const char *group, gsize bytes);
+
+  v8::Local<v8::Object> GetCensus ();
+
+};
@@ -1,9 +1,12 @@
 #include <glib.h>
 #include <nan.h>
 
+#include "census.h"
 #include "closure.h"
 #include "debug.h"
+#include "heap_graph.h"
 #include "loop.h"
+#include "macros.h"
 #include "type.h"
 #include "value.h"
 
@@ -18,6 +21,206 @@ using Nan::Persistent;
 
 namespace GNodeJS {
 
+/*
+ * Functions connected to a GObject are retained by its wrapper, in a private
+ * Map of function -> number of connections.
+ */
+static Local<v8::Map> GetHandlers (Local<Context> context, Local<Object> owner, bool create) {
+    auto key = UTF8("__handlers__");
+    Local<Value> handlers;
+
+    if (Nan::GetPrivate (owner, key).ToLocal (&handlers) && handlers->IsMap ())
+        return handlers.As<v8::Map> ();
+
+    if (!create)
+        return Local<v8::Map> ();
+
+    auto map = v8::Map::New (context->GetIsolate ());
+    Nan::SetPrivate (owner, key, map);
+    return map;
+}
+
+static void RetainHandler (Local<Object> owner, Local<Function> function) {
+    Local<Context> context = Nan::GetCurrentContext ();
+    Local<v8::Map> handlers = GetHandlers (context, owner, true);
+
+    Local<Value> count = handlers->Get (context, function).ToLocalChecked ();
+    uint32_t n = count->IsUint32 () ? count.As<v8::Uint32> ()->Value () : 0;
+
+    handlers->Set (context, function, Nan::New<v8::Uint32> (n + 1)).ToLocalChecked ();
+}
+
+static void ReleaseHandler (Local<Object> owner, Local<Function> function) {
+    /* May be called from C code, outside of any context */
+    Local<Context> context = owner->CreationContext ();
+    Context::Scope context_scope (context);
+
+    Local<v8::Map> handlers = GetHandlers (context, owner, false);
+    if (handlers.IsEmpty ())
+        return;
+
+    Local<Value> count = handlers->Get (context, function).ToLocalChecked ();
+    uint32_t n = count->IsUint32 () ? count.As<v8::Uint32> ()->Value () : 0;
+
+    if (n > 1)
+        handlers->Set (context, function, Nan::New<v8::Uint32> (n - 1)).ToLocalChecked ();
+    else
+        handlers->Delete (context, function).FromJust ();
+}
+
+/*
+ * The type the signal is defined on
+ */
+static const char* GetClosureCensusGroup (Closure *closure) {
+    if (closure->info == NULL)
+        return "(none)";
+
+    GIBaseInfo *container = g_base_info_get_container (closure->info);
+
+    if (container != NULL && GI_IS_REGISTERED_TYPE_INFO (container))
+        return g_type_name (g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) container));
+
+    return g_base_info_get_namespace (closure->info);
+}
+
+template<typename T>
+static void ResetWeak (const Nan::WeakCallbackInfo<Nan::Persistent<T>> &info) {
+    info.GetParameter ()->Reset ();
+}
+
+/*
+ * Signal plans are the converters for the parameters of a signal, resolved
+ * once per signal id: fundamental types are converted straight from the
+ * GValue when their GI type agrees, the others through their (preloaded)
+ * GI type.
+ */
+
+struct SignalParam {
+    Local<Value> (*to_v8) (const GValue *gvalue);
+    GITypeInfo *type_info;
+};
+
+struct SignalPlan {
+    guint n_params;
+    SignalParam *params;
+};
+
+static GHashTable *signalPlans = NULL;
+
+static bool IsDirectlyConvertible (GType gtype) {
+    switch (G_TYPE_FUNDAMENTAL (gtype)) {
+        case G_TYPE_BOOLEAN:
+        case G_TYPE_CHAR:
+        case G_TYPE_UCHAR:
+        case G_TYPE_INT:
+        case G_TYPE_UINT:
+        case G_TYPE_ENUM:
+        case G_TYPE_FLAGS:
+        case G_TYPE_FLOAT:
+        case G_TYPE_DOUBLE:
+        case G_TYPE_STRING:
+        case G_TYPE_OBJECT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+ * Whether the GI type of a parameter converts like its GType: a gunichar is
+ * a G_TYPE_UINT but a string in JS, for example.
+ */
+static bool IsMatchingTypeInfo (GITypeInfo *type_info, GType gtype) {
+    GITypeTag tag = g_type_info_get_tag (type_info);
+
+    switch (G_TYPE_FUNDAMENTAL (gtype)) {
+        case G_TYPE_BOOLEAN: return tag == GI_TYPE_TAG_BOOLEAN;
+        case G_TYPE_CHAR:    return tag == GI_TYPE_TAG_INT8;
+        case G_TYPE_UCHAR:   return tag == GI_TYPE_TAG_UINT8;
+        case G_TYPE_INT:     return tag == GI_TYPE_TAG_INT32;
+        case G_TYPE_UINT:    return tag == GI_TYPE_TAG_UINT32;
+        case G_TYPE_FLOAT:   return tag == GI_TYPE_TAG_FLOAT;
+        case G_TYPE_DOUBLE:  return tag == GI_TYPE_TAG_DOUBLE;
+        case G_TYPE_STRING:  return tag == GI_TYPE_TAG_UTF8;
+        default:
+            break;
+    }
+
+    if (tag != GI_TYPE_TAG_INTERFACE)
+        return false;
+
+    GIBaseInfo *interface_info = g_type_info_get_interface (type_info);
+    GIInfoType interface_type = g_base_info_get_type (interface_info);
+    g_base_info_unref (interface_info);
+
+    switch (G_TYPE_FUNDAMENTAL (gtype)) {
+        case G_TYPE_ENUM:   return interface_type == GI_INFO_TYPE_ENUM;
+        case G_TYPE_FLAGS:  return interface_type == GI_INFO_TYPE_FLAGS;
+        case G_TYPE_OBJECT: return interface_type == GI_INFO_TYPE_OBJECT
+                                || interface_type == GI_INFO_TYPE_INTERFACE;
+        default:            return false;
+    }
+}
+
+static SignalPlan* GetSignalPlan (Closure *closure, guint signal_id) {
+    if (G_UNLIKELY (signalPlans == NULL))
+        signalPlans = g_hash_table_new (NULL, NULL);
+
+    auto *plan = (SignalPlan *) g_hash_table_lookup (signalPlans, GUINT_TO_POINTER (signal_id));
+    if (plan != NULL)
+        return plan;
+
+    GSignalQuery query;
+    g_signal_query (signal_id, &query);
+
+    bool has_gi_args = closure->info != NULL
+        && g_callable_info_get_n_args (closure->info) == (gint) query.n_params;
+
+    plan = g_new0 (SignalPlan, 1);
+    plan->n_params = query.n_params;
+    plan->params = g_new0 (SignalParam, query.n_params);
+
+    for (guint i = 0; i < query.n_params; i++) {
+        GType gtype = query.param_types[i] & ~G_SIGNAL_TYPE_STATIC_SCOPE;
+
+        GITypeInfo *type_info = NULL;
+
+        if (has_gi_args) {
+            GIArgInfo *arg_info = g_callable_info_get_arg (closure->info, i);
+            type_info = g_arg_info_get_type (arg_info);
+            g_base_info_unref (arg_info);
+        }
+
+        if (IsDirectlyConvertible (gtype)
+                && (type_info == NULL || IsMatchingTypeInfo (type_info, gtype))) {
+            plan->params[i].to_v8 = GetGValueConverter (gtype)->to_v8;
+            if (type_info != NULL)
+                g_base_info_unref (type_info);
+        } else {
+            /* NULL if neither, see GValueToV8 */
+            plan->params[i].type_info = type_info;
+        }
+    }
+
+    g_hash_table_insert (signalPlans, GUINT_TO_POINTER (signal_id), plan);
+
+    return plan;
+}
+
+static Local<Value> SignalParamToV8 (SignalParam *param, const GValue *gvalue) {
+    if (param->to_v8 != NULL)
+        return param->to_v8 (gvalue);
+
+    if (param->type_info != NULL) {
+        GIArgument argument;
+        memcpy(&argument, &gvalue->data[0], sizeof(GIArgument));
+        // Signal arguments are only valid during the emission: boxed values get copied
+        return GIArgumentToV8(param->type_info, &argument, -1, GI_TRANSFER_NOTHING);
+    }
+
+    return GValueToV8 (gvalue);
+}
+
 void Closure::Marshal(GClosure *base,
                       GValue   *g_return_value,
                       uint argc, const GValue *g_argv,
@@ -26,12 +229,26 @@ void Closure::Marshal(GClosure *base,
     Closure *closure = (Closure *) base;
     Isolate *isolate = Isolate::GetCurrent ();
 
+    /* The wrapper, and the function with it, have been collected: the object
+     * is being released (see finalization.cc) */
+    if (closure->persistent.IsEmpty ())
+        return;
+
     HandleScope scope(isolate);
-    Local<Context> context = Context::New(isolate);
+
+    Local<Function> func = Local<Function>::New(isolate, closure->persistent);
+
+    /* Emissions from the loop don't have an entered context */
+    Local<Context> context = isolate->InContext ()
+        ? isolate->GetCurrentContext ()
+        : func->CreationContext ();
     Context::Scope context_scope(context);
     Nan::TryCatch try_catch;
 
-    Local<Function> func = Local<Function>::New(isolate, closure->persistent);
+    /* Closures are connected to a single signal */
+    auto *hint = (GSignalInvocationHint *) invocation_hint;
+    if (G_UNLIKELY (closure->plan == NULL) && hint != NULL)
+        closure->plan = GetSignalPlan (closure, hint->signal_id);
 
     // We don't pass the implicit instance as first argument
     uint n_js_args = argc - 1;
@@ -42,15 +259,22 @@ void Closure::Marshal(GClosure *base,
         Local<Value> js_args[n_js_args];
     #endif
 
-    for (uint i = 1; i < argc; i++) {
-        GIArgument argument;
-        memcpy(&argument, &g_argv[i].data[0], sizeof(GIArgument));
-        GIArgInfo arg_info;
-        GITypeInfo type_info;
-        g_callable_info_load_arg(closure->info, i - 1, &arg_info);
-        g_arg_info_load_type(&arg_info, &type_info);
+    if (G_LIKELY (closure->plan != NULL && closure->plan->n_params == n_js_args)) {
+        for (uint i = 1; i < argc; i++)
+            js_args[i - 1] = SignalParamToV8 (&closure->plan->params[i - 1], &g_argv[i]);
+    }
+    else {
+        for (uint i = 1; i < argc; i++) {
+            GIArgument argument;
+            memcpy(&argument, &g_argv[i].data[0], sizeof(GIArgument));
+            GIArgInfo arg_info;
+            GITypeInfo type_info;
+            g_callable_info_load_arg(closure->info, i - 1, &arg_info);
+            g_arg_info_load_type(&arg_info, &type_info);
 
-        js_args[i - 1] = GIArgumentToV8(&type_info, &argument);
+            // Signal arguments are only valid during the emission: boxed values get copied
+            js_args[i - 1] = GIArgumentToV8(&type_info, &argument, -1, GI_TRANSFER_NOTHING);
+        }
     }
 
     Local<Object> self = func;
@@ -81,19 +305,64 @@ void Closure::Marshal(GClosure *base,
     #endif
 }
 
+/* The thread closures are made on, where V8 can be used */
+static GThread *mainThread = NULL;
+
 void Closure::Invalidated (gpointer data, GClosure *base) {
     Closure *closure = (Closure *) base;
+
+    /* Closures are invalidated on the thread that disconnects or finalizes
+     * the object. Off the main thread, the function stays in the wrapper's
+     * Map, and is released with the wrapper. */
+    if (!closure->owner.IsEmpty () && !closure->persistent.IsEmpty ()
+            && g_thread_self () == mainThread) {
+        HandleScope scope(Isolate::GetCurrent ());
+        ReleaseHandler (Nan::New (closure->owner), Nan::New (closure->persistent));
+    }
+
+    HeapGraphRemoveClosure (closure);
+    CensusRemove (CENSUS_CLOSURE, GetClosureCensusGroup (closure), sizeof (Closure));
     closure->~Closure();
 }
 
+/* The data of our closures, to find the handlers connected from JS */
+static char closureMarker;
+
 GClosure *MakeClosure (Local<Function> function, GICallableInfo* info) {
-    Closure *closure = (Closure *) g_closure_new_simple (sizeof (*closure), NULL);
+    if (G_UNLIKELY (mainThread == NULL))
+        mainThread = g_thread_self ();
+
+    Closure *closure = (Closure *) g_closure_new_simple (sizeof (*closure), &closureMarker);
     closure->persistent.Reset(function);
     closure->info = info;
+    closure->plan = NULL;
     GClosure *gclosure = &closure->base;
     g_closure_set_marshal (gclosure, Closure::Marshal);
     g_closure_add_invalidate_notifier (gclosure, NULL, Closure::Invalidated);
+    HeapGraphAddClosure (closure);
+    CensusAdd (CENSUS_CLOSURE, GetClosureCensusGroup (closure), sizeof (Closure));
+    return gclosure;
+}
+
+GClosure *MakeClosure (Local<Function> function, GICallableInfo* info, Local<Object> owner) {
+    GClosure *gclosure = MakeClosure (function, info);
+    Closure *closure = (Closure *) gclosure;
+
+    RetainHandler (owner, function);
+
+    closure->owner.Reset (owner);
+    closure->owner.SetWeak (&closure->owner, ResetWeak<Object>, Nan::WeakCallbackType::kParameter);
+    closure->persistent.SetWeak (&closure->persistent, ResetWeak<Function>, Nan::WeakCallbackType::kParameter);
+
     return gclosure;
 }
 
+/**
+ * Disconnects the handlers connected from JS to @gobject. Returns their number.
+ */
+guint DisconnectClosures (GObject *gobject) {
+    return g_signal_handlers_disconnect_matched (gobject, G_SIGNAL_MATCH_DATA,
+            0, 0, NULL, NULL, &closureMarker);
+}
+
 };
@@ -10,13 +10,28 @@
 
 namespace GNodeJS {
 
+struct SignalPlan;
+
+/*
+ * When a closure is connected to a GObject with a wrapper (@owner), the
+ * function is retained by the wrapper and both handles here are weak, so a
+ * handler capturing its own widget doesn't keep the pair alive forever.
+ *
+ * The wrapper is strong whenever C code holds the object (see the toggle
+ * queue in gobject.cc), so its handlers are too. When it's collected, the
+ * handlers go with it and are disconnected before the object is released
+ * (see DisconnectClosures).
+ */
 struct Closure {
     GClosure base;
     Nan::Persistent<v8::Function> persistent;
+    Nan::Persistent<v8::Object> owner;
     GICallableInfo* info;
+    SignalPlan* plan;
 
     ~Closure() {
         persistent.Reset();
+        owner.Reset();
 
         if (info)
             g_base_info_unref (info);
@@ -32,5 +47,8 @@ struct Closure {
 };
 
 GClosure *MakeClosure(v8::Local<v8::Function> function, GICallableInfo* info);
+GClosure *MakeClosure(v8::Local<v8::Function> function, GICallableInfo* info, v8::Local<v8::Object> owner);
+
+guint     DisconnectClosures(GObject *gobject);
 
 };
@@ -0,0 +1,115 @@
+/*
+ * finalization.cc
+ *
+ * Native releases of collected wrappers (g_object_unref, g_boxed_free, ...)
+ * aren't done inside V8's weak callbacks, where a large tree would run all its
+ * finalizers and dispose cascades in a single GC pause. They are queued, and
+ * run in time-bounded slices from an idle GSource (or a uv idle handle, when
+ * the GLib loop isn't running).
+ */
+
+#include <uv.h>
+
+#include "finalization.h"
+
+namespace GNodeJS {
+
+/* Time budget of a slice */
+#define FINALIZATION_SLICE_USEC 2000
+
+struct Finalization {
+    GDestroyNotify release;
+    gpointer       data;
+    gint64         queued_at;
+};
+
+static GQueue     queue          = G_QUEUE_INIT;
+static guint      idleSourceId   = 0;
+static uv_idle_t *uvIdle         = NULL;
+
+static guint64    totalReleased  = 0;
+static gint64     lastDrainUsec  = 0;
+static gint64     maxLatencyUsec = 0;
+
+static gboolean FinalizationIdle (gpointer user_data);
+static void     FinalizationUvIdle (uv_idle_t *handle);
+
+static void ScheduleDrain () {
+    if (idleSourceId == 0)
+        idleSourceId = g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, FinalizationIdle, NULL, NULL);
+
+    if (uvIdle == NULL) {
+        uvIdle = g_new0 (uv_idle_t, 1);
+        uv_idle_init (uv_default_loop (), uvIdle);
+        /* Doesn't keep the process alive */
+        uv_unref ((uv_handle_t *) uvIdle);
+    }
+
+    if (!uv_is_active ((uv_handle_t *) uvIdle))
+        uv_idle_start (uvIdle, FinalizationUvIdle);
+}
+
+/**
+ * Queues @release(@data) to be called outside of the garbage collector
+ */
+void QueueFinalization (GDestroyNotify release, gpointer data) {
+    auto *item = g_new (Finalization, 1);
+    item->release = release;
+    item->data = data;
+    item->queued_at = g_get_monotonic_time ();
+
+    g_queue_push_tail (&queue, item);
+
+    if (queue.length == 1)
+        ScheduleDrain ();
+}
+
+/**
+ * Runs queued releases for up to FINALIZATION_SLICE_USEC
+ */
+void DrainFinalizationQueue () {
+    if (g_queue_is_empty (&queue))
+        return;
+
+    gint64 start = g_get_monotonic_time ();
+    gint64 now = start;
+
+    while (!g_queue_is_empty (&queue) && now - start < FINALIZATION_SLICE_USEC) {
+        auto *item = (Finalization *) g_queue_pop_head (&queue);
+
+        item->release (item->data);
+        now = g_get_monotonic_time ();
+
+        maxLatencyUsec = MAX (maxLatencyUsec, now - item->queued_at);
+        totalReleased++;
+        g_free (item);
+    }
+
+    lastDrainUsec = now - start;
+}
+
+static gboolean FinalizationIdle (gpointer user_data) {
+    DrainFinalizationQueue ();
+
+    if (!g_queue_is_empty (&queue))
+        return G_SOURCE_CONTINUE;
+
+    idleSourceId = 0;
+    return G_SOURCE_REMOVE;
+}
+
+static void FinalizationUvIdle (uv_idle_t *handle) {
+    DrainFinalizationQueue ();
+
+    if (g_queue_is_empty (&queue))
+        uv_idle_stop (handle);
+}
+
+void GetFinalizationStats (guint *pending, guint64 *released, gint64 *last_drain_usec, gint64 *max_latency_usec) {
+    *pending = queue.length;
+    *released = totalReleased;
+    *last_drain_usec = lastDrainUsec;
+    *max_latency_usec = maxLatencyUsec;
+}
+
+};
@@ -0,0 +1,14 @@
+
+#pragma once
+
+#include <glib.h>
+
+namespace GNodeJS {
+
+  void  QueueFinalization (GDestroyNotify release, gpointer data);
+
+  void  DrainFinalizationQueue ();
+
+  void  GetFinalizationStats (guint *pending, guint64 *released, gint64 *last_drain_usec, gint64 *max_latency_usec);
+
+};
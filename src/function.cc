@@ -4,11 +4,13 @@
 
 #include "boxed.h"
 #include "callback.h"
+#include "census.h"
 #include "debug.h"
 #include "error.h"
 #include "function.h"
 #include "gobject.h"
 #include "macros.h"
+#include "region.h"
 #include "type.h"
 #include "value.h"
 
@@ -26,16 +28,23 @@ using Nan::WeakCallbackType;
 
 namespace GNodeJS {
 
-static void FillArgument(GIArgInfo *arg_info, GIArgument *argument, Local<Value> value) {
+static bool FillArgument(GIArgInfo *arg_info, GIArgument *argument, Local<Value> value) {
     GITypeInfo type_info;
     bool may_be_null = g_arg_info_may_be_null (arg_info);
     g_arg_info_load_type (arg_info, &type_info);
-    V8ToGIArgument(&type_info, argument, value, may_be_null);
+
+    if (!V8ToGIArgument(&type_info, argument, value, may_be_null))
+        return false;
+
+    RefTransferredGObject(&type_info, argument, g_arg_info_get_ownership_transfer (arg_info));
+    return true;
 }
 
 static int GetV8ArrayLength (Local<Value> value) {
     if (value->IsArray())
         return Local<Array>::Cast (TO_OBJECT (value))->Length();
+    else if (IsStructArrayView (value))
+        return GetArrayLikeLength (value);
     else if (value->IsString())
         return TO_STRING (value)->Length();
     else if (value->IsNull() || value->IsUndefined())
@@ -53,7 +62,10 @@ static void* AllocateArgument (GIBaseInfo *arg_info) {
 
     GIBaseInfo* base_info = g_type_info_get_interface (&arg_type);
     size_t size = Boxed::GetSize (base_info);
-    void* pointer = g_slice_alloc0 (size);
+    void* pointer = RegionAlloc (size);
+
+    if (pointer == NULL)
+        pointer = g_slice_alloc0 (size);
 
     g_base_info_unref(base_info);
     return pointer;
@@ -84,6 +96,53 @@ bool IsDestroyNotify (GIBaseInfo *info) {
 }
 
 
+/**
+ * Frees the first @n_args arguments of a call. If the call wasn't made,
+ * callbacks of any scope are released: C code never saw them.
+ */
+static void FreeArguments (FunctionInfo *func, GIArgument *callable_arg_values, int n_args, bool called) {
+    for (int i = 0; i < n_args; i++) {
+        GIArgInfo  arg_info = {};
+        GITypeInfo arg_type;
+        GIArgument arg_value = callable_arg_values[i];
+        Parameter &param = func->call_parameters[i];
+
+        g_callable_info_load_arg ((GICallableInfo *) func->info, i, &arg_info);
+        g_arg_info_load_type (&arg_info, &arg_type);
+
+        GIDirection direction = g_arg_info_get_direction (&arg_info);
+        GITransfer transfer   = g_arg_info_get_ownership_transfer (&arg_info);
+
+        if (param.type == ParameterType::ARRAY) {
+            if (direction == GI_DIRECTION_INOUT || direction == GI_DIRECTION_OUT)
+                FreeGIArgumentArray (&arg_type, (GIArgument*)arg_value.v_pointer, transfer, direction, param.length);
+            else
+                FreeGIArgumentArray (&arg_type, &arg_value, transfer, direction, param.length);
+        }
+        else if (param.type == ParameterType::CALLBACK) {
+            Callback *callback = static_cast<Callback*>(func->call_parameters[i].data.v_pointer);
+
+            g_assert(direction == GI_DIRECTION_IN);
+
+            if (callback != NULL && (!called || callback->scope_type == GI_SCOPE_TYPE_CALL)) {
+                Callback::Release (callback);
+            }
+        }
+        else {
+            /* C never received it: it's still ours to free */
+            if (!called && direction == GI_DIRECTION_IN && transfer == GI_TRANSFER_EVERYTHING) {
+                UnrefTransferredGObject (&arg_type, &arg_value, transfer);
+                transfer = GI_TRANSFER_NOTHING;
+            }
+
+            if (direction == GI_DIRECTION_INOUT || (direction == GI_DIRECTION_OUT && !g_arg_info_is_caller_allocates (&arg_info)))
+                FreeGIArgument (&arg_type, (GIArgument*)arg_value.v_pointer, transfer, direction);
+            else
+                FreeGIArgument (&arg_type, &arg_value, transfer, direction);
+        }
+    }
+}
+
 /**
  * Calls a function
  * @param func the function info
@@ -128,7 +187,8 @@ Local<Value> FunctionCall (
 
     if (func->is_method) {
         GIBaseInfo *container = g_base_info_get_container (gi_info);
-        V8ToGIArgument(container, &total_arg_values[0], info.This());
+        if (!V8ToGIArgument(container, &total_arg_values[0], info.This()))
+            return jsReturnValue;
         callable_arg_values = &total_arg_values[1];
     } else {
         callable_arg_values = &total_arg_values[0];
@@ -183,16 +243,22 @@ Local<Value> FunctionCall (
         else if (param.type == ParameterType::CALLBACK) {
             // GIScopeType scope = g_arg_info_get_scope(&arg_info);
             Callback *callback;
-            ffi_closure *closure;
+            void *closure;
 
             if (info[in_arg]->IsNullOrUndefined()) {
                 closure  = nullptr;
                 callback = nullptr;
             } else {
                 GICallableInfo *callback_info = g_type_info_get_interface (&type_info);
-                callback = new Callback(info[in_arg].As<Function>(), callback_info, &arg_info);
-                closure = callback->closure;
+                callback = Callback::Acquire(info[in_arg].As<Function>(), callback_info, &arg_info);
                 g_base_info_unref (callback_info);
+
+                if (callback == NULL) {
+                    FreeArguments (func, callable_arg_values, i, false);
+                    return jsReturnValue;
+                }
+
+                closure = callback->code;
             }
 
             int destroy_i = g_arg_info_get_destroy(&arg_info);
@@ -225,8 +291,10 @@ Local<Value> FunctionCall (
             // Callback GIArgument is filled above, for the rest...
             if (param.type != ParameterType::CALLBACK) {
 
-                // FIXME(handle failure here)
-                FillArgument(&arg_info, &callable_arg_values[i], info[in_arg]);
+                if (!FillArgument(&arg_info, &callable_arg_values[i], info[in_arg])) {
+                    FreeArguments (func, callable_arg_values, i, false);
+                    return jsReturnValue;
+                }
 
                 // Add a level of indirection for INOUT arguments
                 if (direction == GI_DIRECTION_INOUT) {
@@ -278,7 +346,8 @@ Local<Value> FunctionCall (
         jsReturnValue = func->GetReturnValue (
                 &return_type,
                 use_return_value ? return_value : &return_value_stack,
-                callable_arg_values);
+                callable_arg_values,
+                func->is_method ? info.This() : Local<Object>());
     } else {
         jsReturnValue = Nan::Undefined();
     }
@@ -291,40 +360,7 @@ Local<Value> FunctionCall (
     if (!use_return_value)
         FreeGIArgument(&return_type, &return_value_stack, return_transfer);
 
-    for (int i = 0; i < func->n_callable_args; i++) {
-        GIArgInfo  arg_info = {};
-        GITypeInfo arg_type;
-        GIArgument arg_value = callable_arg_values[i];
-        Parameter &param = func->call_parameters[i];
-
-        g_callable_info_load_arg ((GICallableInfo *) gi_info, i, &arg_info);
-        g_arg_info_load_type (&arg_info, &arg_type);
-
-        GIDirection direction = g_arg_info_get_direction (&arg_info);
-        GITransfer transfer   = g_arg_info_get_ownership_transfer (&arg_info);
-
-        if (param.type == ParameterType::ARRAY) {
-            if (direction == GI_DIRECTION_INOUT || direction == GI_DIRECTION_OUT)
-                FreeGIArgumentArray (&arg_type, (GIArgument*)arg_value.v_pointer, transfer, direction, param.length);
-            else
-                FreeGIArgumentArray (&arg_type, &arg_value, transfer, direction, param.length);
-        }
-        else if (param.type == ParameterType::CALLBACK) {
-            Callback *callback = static_cast<Callback*>(func->call_parameters[i].data.v_pointer);
-
-            g_assert(direction == GI_DIRECTION_IN);
-
-            if (callback->scope_type == GI_SCOPE_TYPE_CALL) {
-                delete callback;
-            }
-        }
-        else {
-            if (direction == GI_DIRECTION_INOUT || (direction == GI_DIRECTION_OUT && !g_arg_info_is_caller_allocates (&arg_info)))
-                FreeGIArgument (&arg_type, (GIArgument*)arg_value.v_pointer, transfer, direction);
-            else
-                FreeGIArgument (&arg_type, &arg_value, transfer, direction);
-        }
-    }
+    FreeArguments (func, callable_arg_values, func->n_callable_args, true);
 
     return jsReturnValue;
 }
@@ -519,7 +555,7 @@ bool FunctionInfo::TypeCheck (const Nan::FunctionCallbackInfo<Value> &arguments)
  * Creates the JS return value from the C arguments list
  * @returns the JS return value
  */
-Local<Value> FunctionInfo::GetReturnValue (GITypeInfo* return_type, GIArgument* return_value, GIArgument* callable_arg_values) {
+Local<Value> FunctionInfo::GetReturnValue (GITypeInfo* return_type, GIArgument* return_value, GIArgument* callable_arg_values, Local<Object> self) {
 
     Local<Value> jsReturnValue;
     int jsReturnIndex = 0;
@@ -537,7 +573,9 @@ Local<Value> FunctionInfo::GetReturnValue (GITypeInfo* return_type, GIArgument*
         int length_i = g_type_info_get_array_length(return_type);
         if (length_i >= 0)
             length = callable_arg_values[length_i].v_long;
-        ADD_RETURN (GIArgumentToV8 (return_type, return_value, length))
+        // Borrowed return values of methods are views tied to the instance
+        GITransfer transfer = g_callable_info_get_caller_owns(info);
+        ADD_RETURN (GIArgumentToV8 (return_type, return_value, length, transfer, self))
     }
 
     for (int i = 0; i < n_callable_args; i++) {
@@ -551,6 +589,10 @@ Local<Value> FunctionInfo::GetReturnValue (GITypeInfo* return_type, GIArgument*
 
         GIDirection direction = g_arg_info_get_direction (&arg_info);
 
+        // Caller-allocated arguments were allocated by us
+        GITransfer transfer = g_arg_info_is_caller_allocates (&arg_info) ?
+            GI_TRANSFER_EVERYTHING : g_arg_info_get_ownership_transfer (&arg_info);
+
         if (direction == GI_DIRECTION_OUT || direction == GI_DIRECTION_INOUT) {
 
             if (param.type == ParameterType::ARRAY) {
@@ -565,7 +607,7 @@ Local<Value> FunctionInfo::GetReturnValue (GITypeInfo* return_type, GIArgument*
                 else
                     param.length = callable_arg_values[length_i].v_long;
 
-                Local<Value> result = ArrayToV8(&arg_type, *(void**)arg_value.v_pointer, param.length);
+                Local<Value> result = ArrayToV8(&arg_type, *(void**)arg_value.v_pointer, param.length, transfer, self);
 
                 ADD_RETURN (result)
 
@@ -575,10 +617,10 @@ Local<Value> FunctionInfo::GetReturnValue (GITypeInfo* return_type, GIArgument*
 
                 if (isPointer) {
                     void *pointer = &arg_value.v_pointer;
-                    ADD_RETURN (GIArgumentToV8(&arg_type, (GIArgument*) pointer))
+                    ADD_RETURN (GIArgumentToV8(&arg_type, (GIArgument*) pointer, -1, transfer, self))
                 }
                 else {
-                    ADD_RETURN (GIArgumentToV8(&arg_type, (GIArgument*) arg_value.v_pointer))
+                    ADD_RETURN (GIArgumentToV8(&arg_type, (GIArgument*) arg_value.v_pointer, -1, transfer, self))
                 }
             }
         }
@@ -618,6 +660,8 @@ Local<Function> MakeFunction(GIBaseInfo *info) {
     Persistent<FunctionTemplate> persistent(Isolate::GetCurrent(), tpl);
     persistent.SetWeak(func, FunctionDestroyed, WeakCallbackType::kParameter);
 
+    CensusAdd (CENSUS_FUNCTION, g_base_info_get_namespace (info), sizeof (FunctionInfo));
+
     return fn;
 }
 
@@ -636,6 +680,7 @@ void FunctionInvoker(const Nan::FunctionCallbackInfo<Value> &info) {
 
 void FunctionDestroyed(const v8::WeakCallbackInfo<FunctionInfo> &data) {
     FunctionInfo *func = data.GetParameter ();
+    CensusRemove (CENSUS_FUNCTION, g_base_info_get_namespace (func->info), sizeof (FunctionInfo));
     delete func;
 }
 
@@ -750,6 +795,8 @@ MaybeLocal<Function> MakeVirtualFunction(GIBaseInfo *info, GType implementor) {
     Persistent<FunctionTemplate> persistent(Isolate::GetCurrent(), tpl);
     persistent.SetWeak(func, FunctionDestroyed, WeakCallbackType::kParameter);
 
+    CensusAdd (CENSUS_FUNCTION, g_base_info_get_namespace (info), sizeof (FunctionInfo));
+
     return MaybeLocal<Function>(fn);
 }
 
@@ -11,6 +11,7 @@
 using v8::Function;
 using v8::Local;
 using v8::MaybeLocal;
+using v8::Object;
 using v8::String;
 
 namespace GNodeJS {
@@ -46,7 +47,7 @@ struct FunctionInfo {
 
     bool Init();
     bool TypeCheck (const Nan::FunctionCallbackInfo<Value> &info);
-    Local<Value> GetReturnValue (GITypeInfo* return_type, GIArgument* return_value, GIArgument* callable_arg_values);
+    Local<Value> GetReturnValue (GITypeInfo* return_type, GIArgument* return_value, GIArgument* callable_arg_values, Local<Object> self);
     void FreeReturnValue (GIArgument *return_value);
 };
 
@@ -7,11 +7,14 @@
 #include "function.h"
 #include "gi.h"
 #include "gobject.h"
+#include "heap_graph.h"
 #include "loop.h"
 #include "macros.h"
+#include "region.h"
 #include "type.h"
 #include "util.h"
 #include "value.h"
+#include "variant.h"
 #include "modules/system.h"
 
 using namespace v8;
@@ -23,6 +26,11 @@ namespace GNodeJS {
     G_DEFINE_QUARK(gnode_js_template,    template);
     G_DEFINE_QUARK(gnode_js_constructor, constructor);
     G_DEFINE_QUARK(gnode_js_function,    function);
+    G_DEFINE_QUARK(gnode_js_converter,   converter);
+    G_DEFINE_QUARK(gnode_js_plans,       plans);
+    G_DEFINE_QUARK(gnode_js_property_cache, property_cache);
+    G_DEFINE_QUARK(gnode_js_class_info,  class_info);
+    G_DEFINE_QUARK(gnode_js_external_size, external_size);
 
     Nan::Persistent<Object> moduleCache(Nan::New<Object>());
 
@@ -115,6 +123,10 @@ NAN_METHOD(Bootstrap) {
     info.GetReturnValue().Set(module_obj);
 }
 
+NAN_METHOD(NamespaceLoaded) {
+    GNodeJS::ForgetParentObjectInfos ();
+}
+
 NAN_METHOD(GetConstantValue) {
     GIBaseInfo *gi_info = (GIBaseInfo *) GNodeJS::BoxedFromWrapper (info[0]);
     GITypeInfo *type = g_constant_info_get_type ((GIConstantInfo *) gi_info);
@@ -136,15 +148,20 @@ NAN_METHOD(MakeFunction) {
 }
 
 NAN_METHOD(MakeVirtualFunction) {
-    if (info.Length() < 2 || !info[0]->IsObject() || !info[1]->IsNumber()) {
+    if (info.Length() < 2 || !info[0]->IsObject() || !(info[1]->IsNumber() || info[1]->IsBigInt())) {
         Nan::ThrowTypeError("Incorrect arguments. Expecting (GIBaseInfo, GType)");
         return;
     }
 
+    guint64 implementor;
+    if (!GNodeJS::V8ToUint64 (info[1], &implementor)) {
+        Nan::ThrowRangeError("Invalid GType");
+        return;
+    }
+
     BaseInfo gi_info(info[0]);
-    GType implementor = (gulong) Nan::To<int64_t> (info[1]).ToChecked();
 
-    MaybeLocal<Function> maybeFn = GNodeJS::MakeVirtualFunction(*gi_info, implementor);
+    MaybeLocal<Function> maybeFn = GNodeJS::MakeVirtualFunction(*gi_info, (GType) implementor);
 
     if (maybeFn.IsEmpty())
         return;
@@ -216,6 +233,30 @@ NAN_METHOD(ObjectPropertySetter) {
     }
 }
 
+NAN_METHOD(MakePropertyAccessors) {
+    BaseInfo prop_info(info[0]);
+    RETURN(GNodeJS::MakePropertyAccessors(*prop_info));
+}
+
+NAN_METHOD(BatchNotifyBegin) {
+    GNodeJS::BatchNotifyBegin();
+}
+
+NAN_METHOD(BatchNotifyEnd) {
+    GNodeJS::BatchNotifyEnd();
+}
+
+NAN_METHOD(SetPropertyCache) {
+    guint64 gtype;
+
+    if (!GNodeJS::V8ToUint64(info[0], &gtype) || !info[1]->IsArray()) {
+        Nan::ThrowTypeError("Incorrect arguments. Expecting (GType, Array, Boolean)");
+        return;
+    }
+
+    GNodeJS::SetPropertyCache((GType) gtype, info[1].As<Array>(), Nan::To<bool>(info[2]).FromJust());
+}
+
 NAN_METHOD(StructFieldSetter) {
     Local<Object> boxedWrapper = info[0].As<Object>();
     Local<Object> fieldInfo    = info[1].As<Object>();
@@ -223,10 +264,15 @@ NAN_METHOD(StructFieldSetter) {
 
     void        *boxed = GNodeJS::BoxedFromWrapper(boxedWrapper);
     GIFieldInfo *field = (GIFieldInfo *) GNodeJS::BoxedFromWrapper(fieldInfo);
-    GITypeInfo  *field_type = g_field_info_get_type(field);
 
-    g_assert(boxed);
+    if (boxed == NULL) {
+        Nan::ThrowError("Boxed has been released (used outside of its region?)");
+        return;
+    }
+
     g_assert(field);
+
+    GITypeInfo  *field_type = g_field_info_get_type(field);
     g_assert(field_type);
 
     GIArgument arg;
@@ -237,14 +283,10 @@ NAN_METHOD(StructFieldSetter) {
         Nan::ThrowTypeError (message);
         g_free(message);
 
-        RETURN (Nan::Undefined());
-
     } else {
 
-        if (g_field_info_set_field(field, boxed, &arg) == FALSE) {
+        if (g_field_info_set_field(field, boxed, &arg) == FALSE)
             Nan::ThrowError("Unable to set field (complex types not allowed)");
-            RETURN (Nan::Undefined());
-        }
 
         /*
          * g_field_info_set_field:
@@ -279,7 +321,7 @@ NAN_METHOD(StructFieldGetter) {
     GIFieldInfo *field = (GIFieldInfo *) GNodeJS::BoxedFromWrapper(fieldInfo);
 
     if (boxed == NULL) {
-        Nan::ThrowError("StructFieldGetter: instance is NULL");
+        Nan::ThrowError("Boxed has been released (used outside of its region?)");
         return;
     }
 
@@ -295,10 +337,38 @@ NAN_METHOD(StructFieldGetter) {
     }
 
     GITypeInfo  *field_type = g_field_info_get_type(field);
-    RETURN(GNodeJS::GIArgumentToV8(field_type, &value));
+    // Pointer fields are owned by the struct
+    RETURN(GNodeJS::GIArgumentToV8(field_type, &value, -1, GI_TRANSFER_NOTHING, boxedWrapper));
     g_base_info_unref (field_type);
 }
 
+NAN_METHOD(DefineStructField) {
+    Local<Object> prototype = info[0].As<Object>();
+    Local<Object> fieldInfo = info[1].As<Object>();
+    Local<String> name      = info[2].As<String>();
+
+    GIFieldInfo *field = (GIFieldInfo *) GNodeJS::BoxedFromWrapper(fieldInfo);
+
+    RETURN(GNodeJS::DefineStructField (prototype, field, name));
+}
+
+NAN_METHOD(RegisterStructArrayView) {
+    if (!info[0]->IsFunction()) {
+        Nan::ThrowTypeError("Incorrect arguments. Expecting (Function)");
+        return;
+    }
+
+    GNodeJS::RegisterStructArrayView (info[0].As<Function>());
+}
+
+NAN_METHOD(RegionEnter) {
+    GNodeJS::RegionEnter ();
+}
+
+NAN_METHOD(RegionExit) {
+    GNodeJS::RegionExit ();
+}
+
 NAN_METHOD(StartLoop) {
     GNodeJS::StartLoop ();
 }
@@ -320,6 +390,67 @@ NAN_METHOD(GetLoopStack) {
     info.GetReturnValue().Set(stack);
 }
 
+NAN_METHOD(SetBigIntMode) {
+    bool enabled = Nan::To<bool> (info[0]).ToChecked();
+
+    if (info[1]->IsString()) {
+        Nan::Utf8String ns (info[1]);
+        GNodeJS::SetBigIntMode (enabled, *ns);
+    } else {
+        GNodeJS::SetBigIntMode (enabled);
+    }
+}
+
+NAN_METHOD(RegisterValueConverter) {
+    if (info.Length() < 1 || !(info[0]->IsNumber() || info[0]->IsBigInt())) {
+        Nan::ThrowTypeError("Incorrect arguments. Expecting (GType, Function?, Function?)");
+        return;
+    }
+
+    guint64 gtype;
+    if (!GNodeJS::V8ToUint64 (info[0], &gtype) || !G_TYPE_IS_VALUE_TYPE ((GType) gtype)) {
+        Nan::ThrowTypeError("Invalid GType");
+        return;
+    }
+
+    GNodeJS::RegisterJSValueConverter ((GType) gtype, info[1], info[2]);
+}
+
+NAN_METHOD(VariantDeepUnpack) {
+    if (!GNodeJS::ValueIsInstanceOfGType (info[0], G_TYPE_VARIANT)) {
+        Nan::ThrowTypeError("Incorrect arguments. Expecting (GLib.Variant)");
+        return;
+    }
+
+    GVariant *variant = (GVariant *) GNodeJS::BoxedFromWrapper (info[0]);
+    RETURN(GNodeJS::UnpackVariant (variant));
+}
+
+NAN_METHOD(VariantPack) {
+    if (!info[0]->IsString()) {
+        Nan::ThrowTypeError("Incorrect arguments. Expecting (String, Any)");
+        return;
+    }
+
+    Nan::Utf8String type_string (info[0]);
+    const GVariantType *type = GNodeJS::GetVariantType (*type_string);
+
+    if (type == NULL || !g_variant_type_is_definite (type)) {
+        Nan::ThrowTypeError("Invalid GVariant type string");
+        return;
+    }
+
+    GVariant *variant = GNodeJS::PackVariant (type, info[1]);
+    if (variant == NULL)
+        return;
+
+    GIBaseInfo *variant_info = g_irepository_find_by_gtype (NULL, G_TYPE_VARIANT);
+    Local<Value> wrapper = GNodeJS::WrapperFromBoxed (variant_info, variant);
+    g_base_info_unref (variant_info);
+
+    RETURN(wrapper);
+}
+
 NAN_METHOD(GetModuleCache) {
     info.GetReturnValue().Set(Nan::New<Object>(GNodeJS::moduleCache));
 }
@@ -327,6 +458,7 @@ NAN_METHOD(GetModuleCache) {
 void InitModule(Local<Object> exports, Local<Value> module, void *priv) {
     NAN_EXPORT(exports, Bootstrap);
     NAN_EXPORT(exports, GetModuleCache);
+    NAN_EXPORT(exports, NamespaceLoaded);
     NAN_EXPORT(exports, GetConstantValue);
     NAN_EXPORT(exports, MakeBoxedClass);
     NAN_EXPORT(exports, MakeObjectClass);
@@ -334,14 +466,29 @@ void InitModule(Local<Object> exports, Local<Value> module, void *priv) {
     NAN_EXPORT(exports, MakeVirtualFunction);
     NAN_EXPORT(exports, StructFieldGetter);
     NAN_EXPORT(exports, StructFieldSetter);
+    NAN_EXPORT(exports, DefineStructField);
+    NAN_EXPORT(exports, RegisterStructArrayView);
+    NAN_EXPORT(exports, RegionEnter);
+    NAN_EXPORT(exports, RegionExit);
     NAN_EXPORT(exports, ObjectPropertyGetter);
     NAN_EXPORT(exports, ObjectPropertySetter);
+    NAN_EXPORT(exports, MakePropertyAccessors);
+    NAN_EXPORT(exports, BatchNotifyBegin);
+    NAN_EXPORT(exports, BatchNotifyEnd);
+    NAN_EXPORT(exports, SetPropertyCache);
     NAN_EXPORT(exports, StartLoop);
     NAN_EXPORT(exports, GetBaseClass);
     NAN_EXPORT(exports, GetTypeSize);
     NAN_EXPORT(exports, GetLoopStack);
+    NAN_EXPORT(exports, SetBigIntMode);
+    NAN_EXPORT(exports, RegisterValueConverter);
+    NAN_EXPORT(exports, VariantDeepUnpack);
+    NAN_EXPORT(exports, VariantPack);
 
     Nan::Set(exports, UTF8("System"), GNodeJS::System::GetModule());
+
+    GNodeJS::StartLoopHooks ();
+    GNodeJS::StartHeapGraph ();
 }
 
 NODE_MODULE(node_gtk, InitModule)
@@ -34,6 +34,11 @@ GQuark object_quark (void);
 GQuark template_quark (void);
 GQuark constructor_quark (void);
 GQuark function_quark (void);
+GQuark converter_quark (void);
+GQuark plans_quark (void);
+GQuark property_cache_quark (void);
+GQuark class_info_quark (void);
+GQuark external_size_quark (void);
 
 
 /*
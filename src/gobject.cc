@@ -2,12 +2,16 @@
 #include <string.h>
 
 #include "boxed.h"
+#include "census.h"
 #include "closure.h"
 #include "debug.h"
+#include "finalization.h"
 #include "function.h"
 #include "gi.h"
 #include "gobject.h"
+#include "heap_graph.h"
 #include "macros.h"
+#include "memory.h"
 #include "type.h"
 #include "util.h"
 #include "value.h"
@@ -35,67 +39,306 @@ static void GObjectDestroyed(const v8::WeakCallbackInfo<GObject> &data);
 
 static Local<FunctionTemplate> GetClassTemplateFromGI(GIBaseInfo *info);
 
-static bool InitGParameterFromProperty(GParameter    *parameter,
-                                       void          *klass,
-                                       Local<String>  name,
-                                       Local<Value>   value) {
-    Nan::Utf8String name_utf8 (name);
-    GParamSpec *pspec = g_object_class_find_property (G_OBJECT_CLASS (klass), *name_utf8);
+static void GetObjectProperty(GObject *gobject, GParamSpec *pspec, GValue *value);
+static void InvalidatePropertyCache(GObject *gobject, const char *name);
+static void ReleasePropertyCache(GObject *gobject);
+
+/*
+ * Property plans are the resolved GParamSpecs for a set of option keys. They
+ * are cached per class, so `new Class({ ... })` with the same keys doesn't
+ * look up each property by name again.
+ *
+ * Plans are ref-counted: the cache drops its reference when it evicts a plan,
+ * which can happen while one is in use, as converting the values runs JS.
+ */
+
+#define MAX_PROPERTY_PLANS 8
+
+struct PropertyPlan {
+    guint ref_count;
+    guint n_keys;
+    Nan::Persistent<Value> *keys;
+    GParamSpec **pspecs;    /* NULL for keys that aren't properties */
+};
 
-    // Ignore additionnal keys in options, thus return true
-    if (pspec == NULL)
-        return true;
+struct PropertyPlanCache {
+    GObjectClass *klass;
+    GQueue plans;           /* most recently used first */
+};
+
+static void PropertyPlanUnref(PropertyPlan *plan) {
+    if (--plan->ref_count > 0)
+        return;
+
+    for (guint i = 0; i < plan->n_keys; i++)
+        plan->keys[i].Reset();
+    delete[] plan->keys;
+    g_free (plan->pspecs);
+    g_free (plan);
+}
+
+static PropertyPlanCache* GetPropertyPlanCache(GType gtype) {
+    auto *cache = (PropertyPlanCache *) g_type_get_qdata (gtype, GNodeJS::plans_quark());
+
+    if (cache == NULL) {
+        cache = g_new0 (PropertyPlanCache, 1);
+        /* Held as long as the type itself, so the pspecs stay valid */
+        cache->klass = (GObjectClass *) g_type_class_ref (gtype);
+        g_queue_init (&cache->plans);
+        g_type_set_qdata (gtype, GNodeJS::plans_quark(), cache);
+    }
+
+    return cache;
+}
+
+static bool PropertyPlanMatches(PropertyPlan *plan, Local<Array> keys) {
+    if (plan->n_keys != keys->Length())
+        return false;
+
+    for (guint i = 0; i < plan->n_keys; i++) {
+        Local<Value> key = Nan::Get (keys, i).ToLocalChecked();
+        if (!Nan::New (plan->keys[i])->StrictEquals (key))
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Keys may use the GObject name ("use-underline") or the JS one ("useUnderline")
+ */
+static GParamSpec* FindPropertyByKey(GObjectClass *klass, const char *key) {
+    GParamSpec *pspec = g_object_class_find_property (klass, key);
+
+    if (pspec == NULL) {
+        char *name = Util::ToDashedName (key);
+        pspec = g_object_class_find_property (klass, name);
+        g_free (name);
+    }
+
+    return pspec;
+}
+
+/*
+ * Returns a reference to the plan for @keys, to release with PropertyPlanUnref
+ */
+static PropertyPlan* GetPropertyPlan(GType gtype, Local<Array> keys) {
+    PropertyPlanCache *cache = GetPropertyPlanCache (gtype);
+
+    for (GList *link = cache->plans.head; link != NULL; link = link->next) {
+        auto *plan = (PropertyPlan *) link->data;
+
+        if (PropertyPlanMatches (plan, keys)) {
+            if (link != cache->plans.head) {
+                g_queue_unlink (&cache->plans, link);
+                g_queue_push_head_link (&cache->plans, link);
+            }
+            plan->ref_count++;
+            return plan;
+        }
+    }
+
+    guint n_keys = keys->Length();
+    auto *plan = g_new0 (PropertyPlan, 1);
+    /* The cache's & the caller's */
+    plan->ref_count = 2;
+    plan->n_keys = n_keys;
+    plan->keys = new Nan::Persistent<Value>[n_keys];
+    plan->pspecs = g_new0 (GParamSpec *, n_keys);
+
+    for (guint i = 0; i < n_keys; i++) {
+        Local<Value> key = Nan::Get (keys, i).ToLocalChecked();
+        Nan::Utf8String key_utf8 (key);
+        plan->keys[i].Reset (key);
+        plan->pspecs[i] = FindPropertyByKey (cache->klass, *key_utf8);
+    }
 
+    g_queue_push_head (&cache->plans, plan);
+
+    if (cache->plans.length > MAX_PROPERTY_PLANS)
+        PropertyPlanUnref ((PropertyPlan *) g_queue_pop_tail (&cache->plans));
+
+    return plan;
+}
+
+static bool InitGValueFromProperty(GValue *gvalue, GParamSpec *pspec, Local<Value> value) {
     GType value_type = G_PARAM_SPEC_VALUE_TYPE (pspec);
-    parameter->name = pspec->name;
-    g_value_init (&parameter->value, value_type);
+    g_value_init (gvalue, value_type);
 
-    if (!CanConvertV8ToGValue(&parameter->value, value)) {
+    if (!CanConvertV8ToGValue(gvalue, value)) {
         char* message = g_strdup_printf("Cannot convert value for property \"%s\", expected type %s",
-                *name_utf8, g_type_name(value_type));
+                pspec->name, g_type_name(value_type));
         Nan::ThrowTypeError(message);
-        free(message);
+        g_free(message);
+        g_value_unset (gvalue);
         return false;
     }
 
-    if (!V8ToGValue (&parameter->value, value)) {
+    if (!V8ToGValue (gvalue, value)) {
         char* message = g_strdup_printf("Couldn't convert value for property \"%s\", expected type %s",
-                *name_utf8, g_type_name(value_type));
+                pspec->name, g_type_name(value_type));
         Nan::ThrowTypeError(message);
-        free(message);
+        g_free(message);
+        g_value_unset (gvalue);
         return false;
     }
 
     return true;
 }
 
-static bool InitGParametersFromProperty(GParameter    **parameters_p,
-                                        int            *n_parameters_p,
-                                        void           *klass,
-                                        Local<Object>  property_hash) {
-    Local<Array> properties = Nan::GetOwnPropertyNames (property_hash).ToLocalChecked();
-    int n_parameters = properties->Length ();
-    GParameter *parameters = g_new0 (GParameter, n_parameters);
+/* Up to this many values are kept on the stack, the key count is up to JS */
+#define PROPERTY_VALUES_STACK_SIZE 16
+
+/*
+ * The names & GValues passed to g_object_new_with_properties/g_object_setv,
+ * unset when going out of scope
+ */
+struct PropertyValues {
+    const char  *stack_names[PROPERTY_VALUES_STACK_SIZE];
+    GValue       stack_values[PROPERTY_VALUES_STACK_SIZE];
+    const char **names;
+    GValue      *values;
+    int          n_values;
+
+    PropertyValues (guint n_keys) : n_values (0) {
+        if (n_keys <= PROPERTY_VALUES_STACK_SIZE) {
+            names = stack_names;
+            values = stack_values;
+            memset (stack_values, 0, sizeof (stack_values));
+        } else {
+            names = g_new (const char *, n_keys);
+            values = g_new0 (GValue, n_keys);
+        }
+    }
 
-    for (int i = 0; i < n_parameters; i++) {
-        Local<String> name = TO_STRING (properties->Get(i));
-        Local<Value> value = property_hash->Get (name);
+    ~PropertyValues () {
+        for (int i = 0; i < n_values; i++)
+            g_value_unset (&values[i]);
 
-        if (!InitGParameterFromProperty (&parameters[i], klass, TO_STRING (name), value))
-            return false;
+        if (values != stack_values) {
+            g_free (names);
+            g_free (values);
+        }
     }
+};
 
-    *parameters_p = parameters;
-    *n_parameters_p = n_parameters;
-    return true;
+/*
+ * Converts the values of @property_hash following @plan, into @names and
+ * @values (which must hold plan->n_keys elements). Keys that aren't properties
+ * are ignored. Returns the number of values or -1 if an error was thrown.
+ */
+static int InitGValuesFromPlan(PropertyPlan  *plan,
+                               Local<Object>  property_hash,
+                               const char   **names,
+                               GValue        *values) {
+    int n_values = 0;
+
+    for (guint i = 0; i < plan->n_keys; i++) {
+        GParamSpec *pspec = plan->pspecs[i];
+
+        if (pspec == NULL)
+            continue;
+
+        Local<Value> value = Nan::Get (property_hash, Nan::New (plan->keys[i])).ToLocalChecked();
+
+        if (!InitGValueFromProperty (&values[n_values], pspec, value)) {
+            for (int j = 0; j < n_values; j++)
+                g_value_unset (&values[j]);
+            return -1;
+        }
+
+        names[n_values] = pspec->name;
+        n_values++;
+    }
+
+    return n_values;
 }
 
-static void ToggleNotify(gpointer user_data, GObject *gobject, gboolean toggle_down) {
-    void *data = g_object_get_qdata (gobject, GNodeJS::object_quark());
+/*
+ * Notification batches: objects whose properties are set during a batch are
+ * frozen once, and thawed together when the outermost batch ends.
+ */
+
+static int         batchDepth   = 0;
+static GHashTable *batchObjects = NULL;
+
+void BatchNotifyBegin() {
+    if (batchDepth++ == 0 && batchObjects == NULL)
+        batchObjects = g_hash_table_new (NULL, NULL);
+}
+
+void BatchNotifyEnd() {
+    g_assert (batchDepth > 0);
+
+    if (--batchDepth > 0)
+        return;
+
+    GHashTableIter iter;
+    gpointer key;
+
+    /* Thawing emits notify, which may start a new batch: detach first */
+    GHashTable *objects = batchObjects;
+    batchObjects = NULL;
+
+    g_hash_table_iter_init (&iter, objects);
+    while (g_hash_table_iter_next (&iter, &key, NULL)) {
+        g_object_thaw_notify (G_OBJECT (key));
+        g_object_unref (key);
+    }
+
+    g_hash_table_destroy (objects);
+}
+
+static void BatchNotifyTouch(GObject *gobject) {
+    if (G_LIKELY (batchDepth == 0))
+        return;
+
+    if (g_hash_table_add (batchObjects, gobject)) {
+        g_object_ref (gobject);
+        g_object_freeze_notify (gobject);
+    }
+}
 
-    g_assert (data != NULL);
+/*
+ * Objects frozen by the current batch queue their notify until it ends, so
+ * their cached property values can't be trusted in the meantime.
+ */
+static bool IsBatchFrozen(GObject *gobject) {
+    return G_UNLIKELY (batchDepth > 0) && g_hash_table_contains (batchObjects, gobject);
+}
+
+/*
+ * Toggle queue: transitions to weak (toggle down) are deferred and drained
+ * once per loop iteration, before each GC, and when too many are pending
+ * during synchronous code (see DrainToggleQueue), so objects going back and
+ * forth between 1 and 2 refs (eg. reparented widgets) don't flip their
+ * persistent each time. Transitions to strong (toggle up) are applied right
+ * away on the main thread: the wrapper must not be collected while C code
+ * holds a reference, and cancel a pending toggle down. Delaying a toggle down
+ * only delays collection, so it's always safe.
+ */
+
+enum ToggleState {
+    TOGGLE_NONE = 0,
+    TOGGLE_DOWN,
+    TOGGLE_UP,      /* only queued when notified from another thread */
+};
 
-    auto *persistent = (Persistent<Object> *) data;
+/* Pending toggles that make the main thread drain the queue right away */
+#define TOGGLE_QUEUE_MAX_PENDING 1024
+
+static GMutex      toggleMutex;
+static GHashTable *pendingToggles   = NULL;   /* GObject => ToggleState */
+static GThread    *mainThread       = NULL;
+static guint64     togglesApplied   = 0;
+static guint64     togglesCoalesced = 0;
+
+static void ApplyToggle(GObject *gobject, bool toggle_down) {
+    auto *persistent = (Persistent<Object> *) g_object_get_qdata (gobject, GNodeJS::object_quark());
+
+    /* Disposed or destroyed in the meantime */
+    if (persistent == NULL)
+        return;
 
     if (toggle_down) {
         /* We're dropping from 2 refs to 1 ref. We are the last holder. Make
@@ -106,16 +349,129 @@ static void ToggleNotify(gpointer user_data, GObject *gobject, gboolean toggle_d
          * collected, so make sure that our reference is persistent */
         persistent->ClearWeak ();
     }
+
+    togglesApplied++;
+}
+
+static void ToggleNotify(gpointer user_data, GObject *gobject, gboolean toggle_down) {
+    int state = toggle_down ? TOGGLE_DOWN : TOGGLE_UP;
+    bool apply_now = false;
+
+    g_mutex_lock (&toggleMutex);
+
+    if (pendingToggles == NULL)
+        pendingToggles = g_hash_table_new (NULL, NULL);
+
+    int pending = GPOINTER_TO_INT (g_hash_table_lookup (pendingToggles, gobject));
+
+    if (pending != TOGGLE_NONE && pending != state) {
+        /* Opposite transitions cancel out: the applied state is already right */
+        g_hash_table_remove (pendingToggles, gobject);
+        togglesCoalesced++;
+    } else if (state == TOGGLE_UP && g_thread_self () == mainThread) {
+        apply_now = true;
+    } else {
+        if (pending != TOGGLE_NONE)
+            togglesCoalesced++;
+        g_hash_table_insert (pendingToggles, gobject, GINT_TO_POINTER (state));
+    }
+
+    bool drain_now = g_hash_table_size (pendingToggles) > TOGGLE_QUEUE_MAX_PENDING
+        && g_thread_self () == mainThread;
+
+    g_mutex_unlock (&toggleMutex);
+
+    if (apply_now)
+        ApplyToggle (gobject, false);
+
+    if (drain_now)
+        DrainToggleQueue ();
 }
 
+static void CancelToggle(GObject *gobject) {
+    g_mutex_lock (&toggleMutex);
+    if (pendingToggles != NULL)
+        g_hash_table_remove (pendingToggles, gobject);
+    g_mutex_unlock (&toggleMutex);
+}
+
+/*
+ * Applies the pending toggles. Called once per GLib and uv loop iteration,
+ * from the GC prologue, and by ToggleNotify past TOGGLE_QUEUE_MAX_PENDING.
+ * Main thread only.
+ */
+void DrainToggleQueue() {
+    g_mutex_lock (&toggleMutex);
+
+    if (pendingToggles == NULL || g_hash_table_size (pendingToggles) == 0) {
+        g_mutex_unlock (&toggleMutex);
+        return;
+    }
+
+    GHashTable *toggles = pendingToggles;
+    pendingToggles = g_hash_table_new (NULL, NULL);
+    g_mutex_unlock (&toggleMutex);
+
+    GHashTableIter iter;
+    gpointer key, value;
+
+    g_hash_table_iter_init (&iter, toggles);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+        ApplyToggle (G_OBJECT (key), GPOINTER_TO_INT (value) == TOGGLE_DOWN);
+
+    g_hash_table_destroy (toggles);
+}
+
+void GetToggleStats(guint64 *applied, guint64 *coalesced, guint *pending) {
+    g_mutex_lock (&toggleMutex);
+    *applied = togglesApplied;
+    *coalesced = togglesCoalesced;
+    *pending = pendingToggles ? g_hash_table_size (pendingToggles) : 0;
+    g_mutex_unlock (&toggleMutex);
+}
+
+/*
+ * Accounts for a new wrapper of @gobject: external memory, heap snapshots &
+ * census. Reversed by UntrackGObject when it's disposed or collected.
+ */
+static void TrackGObject(GObject *gobject) {
+    /* Let the GC know about the memory the wrapper keeps alive */
+    gsize external_size = EstimateGObjectSize (gobject);
+    g_object_set_qdata (gobject, GNodeJS::external_size_quark(), GSIZE_TO_POINTER (external_size));
+    AdjustExternalMemory (external_size);
+
+    HeapGraphAddGObject (gobject);
+    CensusAdd (CENSUS_GOBJECT, G_OBJECT_TYPE_NAME (gobject), external_size);
+}
+
+static void UntrackGObject(GObject *gobject) {
+    gsize external_size = GPOINTER_TO_SIZE (g_object_get_qdata (gobject, GNodeJS::external_size_quark()));
+    g_object_set_qdata (gobject, GNodeJS::external_size_quark(), NULL);
+    AdjustExternalMemory (-(gint64) external_size);
+
+    HeapGraphRemoveGObject (gobject);
+    CensusRemove (CENSUS_GOBJECT, G_OBJECT_TYPE_NAME (gobject), external_size);
+}
+
+/*
+ * The wrapper holds a single reference, the toggle ref: when it's the last
+ * one, only the wrapper keeps the object alive and can become weak.
+ */
 static void AssociateGObject(Isolate *isolate, Local<Object> object, GObject *gobject) {
+    if (G_UNLIKELY (mainThread == NULL))
+        mainThread = g_thread_self ();
+
     object->SetAlignedPointerInInternalField (0, gobject);
 
+    Persistent<Object> *persistent = new Persistent<Object>(isolate, object);
+    g_object_set_qdata (gobject, GNodeJS::object_quark(), persistent);
+
+    /* Sinks a floating ref, so that it's the one we swap for the toggle ref */
     g_object_ref_sink (gobject);
     g_object_add_toggle_ref (gobject, ToggleNotify, NULL);
+    g_object_unref (gobject);
 
-    Persistent<Object> *persistent = new Persistent<Object>(isolate, object);
-    g_object_set_qdata (gobject, GNodeJS::object_quark(), persistent);
+    TrackGObject (gobject);
 }
 
 static void GObjectConstructor(const FunctionCallbackInfo<Value> &info) {
@@ -140,50 +496,101 @@ static void GObjectConstructor(const FunctionCallbackInfo<Value> &info) {
         void *data = External::Cast (*info[0])->Value ();
         GObject *gobject = G_OBJECT (data);
         AssociateGObject (isolate, self, gobject);
-
-        Nan::DefineOwnProperty(self,
-                Nan::New<String>("__gtype__").ToLocalChecked(),
-                Nan::New<Number>(G_OBJECT_TYPE(gobject)),
-                (v8::PropertyAttribute)(v8::PropertyAttribute::ReadOnly | v8::PropertyAttribute::DontEnum)
-        );
     } else {
         /* User code calling `new Gtk.Widget({ ... })` */
 
-        GObject *gobject;
         GIBaseInfo *gi_info = (GIBaseInfo *) External::Cast (*info.Data ())->Value ();
         GType gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) gi_info);
-        void *klass = g_type_class_ref (gtype);
 
-        GParameter *parameters = NULL;
-        int n_parameters = 0;
+        PropertyPlan *plan = NULL;
+        Local<Object> property_hash;
+        guint n_keys = 0;
 
         if (info[0]->IsObject ()) {
-            Local<Object> property_hash = TO_OBJECT (info[0]);
+            property_hash = TO_OBJECT (info[0]);
+            Local<Array> keys = Nan::GetOwnPropertyNames (property_hash).ToLocalChecked();
+            plan = GetPropertyPlan (gtype, keys);
+            n_keys = plan->n_keys;
+        }
 
-            if (!InitGParametersFromProperty (&parameters, &n_parameters, klass, property_hash)) {
-                // Error will already be thrown from InitGParametersFromProperty
-                goto out;
-            }
+        PropertyValues props (n_keys);
+        int n_values = plan ? InitGValuesFromPlan (plan, property_hash, props.names, props.values) : 0;
+
+        // Error will already be thrown from InitGValuesFromPlan
+        if (n_values < 0) {
+            PropertyPlanUnref (plan);
+            return;
         }
 
-        gobject = (GObject *) g_object_newv (gtype, n_parameters, parameters);
+        props.n_values = n_values;
+
+        GObject *gobject = g_object_new_with_properties (gtype, n_values, props.names, props.values);
+        bool is_floating = g_object_is_floating (gobject);
         AssociateGObject (isolate, self, gobject);
 
-        Nan::DefineOwnProperty(self,
-                UTF8("__gtype__"),
-                Nan::New<Number>(gtype),
-                (v8::PropertyAttribute)(v8::PropertyAttribute::ReadOnly | v8::PropertyAttribute::DontEnum)
-        );
+        /* A floating ref was sunk into the wrapper, a normal one is ours to drop */
+        if (!is_floating)
+            g_object_unref (gobject);
 
-    out:
-        g_free (parameters);
-        g_type_class_unref (klass);
+        /* @props.names point into its pspecs */
+        if (plan != NULL)
+            PropertyPlanUnref (plan);
     }
 }
 
+/*
+ * Detaches @object from @gobject and drops the reference it held. If it was
+ * the last one, the object is disposed & finalized right away. We don't
+ * g_object_run_dispose() objects that are still referenced elsewhere (eg. a
+ * widget in a container), as their other holders still expect them to work.
+ *
+ * The handlers connected from JS are disconnected: they are retained by the
+ * wrapper, and would silently stop firing once it is collected.
+ */
+static void DisposeGObject(Local<Object> object, GObject *gobject) {
+    auto *persistent = (Persistent<Object> *) g_object_get_qdata (gobject, GNodeJS::object_quark());
+
+    g_object_set_qdata (gobject, GNodeJS::object_quark(), NULL);
+    /* Also cancels the weak callback, if it was pending */
+    delete persistent;
+
+    object->SetAlignedPointerInInternalField (0, NULL);
+
+    /* Their memory may go away with the object */
+    DetachBoxedViews (gobject);
+    ReleasePropertyCache (gobject);
+    DisconnectClosures (gobject);
+
+    UntrackGObject (gobject);
+    CancelToggle (gobject);
+    g_object_remove_toggle_ref (gobject, ToggleNotify, NULL);
+}
+
+/*
+ * Drops the reference held by a collected wrapper. Deferred out of the GC,
+ * as it may run dispose handlers (see finalization.cc)
+ */
+static void ReleaseGObject(gpointer data) {
+    GObject *gobject = G_OBJECT (data);
+    /* C code may have toggled it since the wrapper was collected */
+    CancelToggle (gobject);
+
+    /* The handlers connected from JS were collected with the wrapper: they
+     * mustn't stay connected as no-ops, eg. for "destroy" during disposal */
+    guint n_handlers = DisconnectClosures (gobject);
+
+    if (n_handlers > 0 && g_atomic_int_get (&gobject->ref_count) > 1)
+        warn ("%s collected while still referenced: disconnected %u signal handlers",
+                G_OBJECT_TYPE_NAME (gobject), n_handlers);
+
+    g_object_remove_toggle_ref (gobject, ToggleNotify, NULL);
+}
+
 static void GObjectDestroyed(const v8::WeakCallbackInfo<GObject> &data) {
     GObject *gobject = data.GetParameter ();
 
+    CancelToggle (gobject);
+
     void *type_data = g_object_get_qdata (gobject, GNodeJS::object_quark());
     Persistent<Object> *persistent = (Persistent<Object> *) type_data;
     delete persistent;
@@ -192,7 +599,10 @@ static void GObjectDestroyed(const v8::WeakCallbackInfo<GObject> &data) {
      * the qdata that points back to us. */
     g_object_set_qdata (gobject, GNodeJS::object_quark(), NULL);
 
-    g_object_unref (gobject);
+    ReleasePropertyCache (gobject);
+    UntrackGObject (gobject);
+
+    QueueFinalization (ReleaseGObject, gobject);
 }
 
 static void GObjectClassDestroyed(const v8::WeakCallbackInfo<GIBaseInfo> &info) {
@@ -244,6 +654,57 @@ out:
     return signal_info;
 }
 
+/* GType => object info of the closest introspected parent, for types that
+ * aren't introspected themselves. Unlike exact matches, these go stale when a
+ * namespace is loaded, as it may introspect the type. */
+static GHashTable *parentObjectInfos = NULL;
+
+/**
+ * Returns the object info of the most-derived introspected class of @gtype,
+ * walking up the parents for private types (eg. GtkBuilder-created GtkWindow
+ * subclasses). The result is cached and must not be unref'd.
+ */
+static GIBaseInfo* GetIntrospectedObjectInfo(GType gtype) {
+    auto *object_info = (GIBaseInfo *) g_type_get_qdata (gtype, GNodeJS::class_info_quark());
+
+    if (G_LIKELY (object_info != NULL))
+        return object_info;
+
+    if (parentObjectInfos != NULL) {
+        object_info = (GIBaseInfo *) g_hash_table_lookup (parentObjectInfos, GSIZE_TO_POINTER (gtype));
+        if (object_info != NULL)
+            return object_info;
+    }
+
+    object_info = g_irepository_find_by_gtype (NULL, gtype);
+
+    if (object_info != NULL) {
+        g_type_set_qdata (gtype, GNodeJS::class_info_quark(), object_info);
+        return object_info;
+    }
+
+    for (GType parent = g_type_parent (gtype); parent != G_TYPE_INVALID && object_info == NULL; parent = g_type_parent (parent))
+        object_info = g_irepository_find_by_gtype (NULL, parent);
+
+    g_assert (object_info != NULL);
+
+    if (parentObjectInfos == NULL)
+        parentObjectInfos = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) g_base_info_unref);
+
+    g_hash_table_insert (parentObjectInfos, GSIZE_TO_POINTER (gtype), object_info);
+
+    return object_info;
+}
+
+/**
+ * Forgets the parent infos used for types that weren't introspected, once a
+ * namespace has been loaded
+ */
+void ForgetParentObjectInfos() {
+    if (parentObjectInfos != NULL)
+        g_hash_table_remove_all (parentObjectInfos);
+}
+
 static void ThrowSignalNotFound(GIBaseInfo *object_info, const char* signal_name) {
     char *message = g_strdup_printf("Signal \"%s\" not found for instance of %s",
             signal_name, GetInfoName(object_info));
@@ -251,13 +712,29 @@ static void ThrowSignalNotFound(GIBaseInfo *object_info, const char* signal_name
     g_free(message);
 }
 
+/*
+ * Returns the GObject of a wrapper, or throws if it isn't one or if it has
+ * been disposed.
+ */
+static GObject* GObjectFromWrapperChecked(Local<Value> value) {
+    if (!ValueIsGObject (value)) {
+        Nan::ThrowTypeError("Object is not a GObject");
+        return NULL;
+    }
+
+    GObject *gobject = GObjectFromWrapper (value);
+
+    if (gobject == NULL)
+        Nan::ThrowError("Object has been disposed");
+
+    return gobject;
+}
+
 static void SignalConnectInternal(const Nan::FunctionCallbackInfo<v8::Value> &info, bool after) {
-    GObject *gobject = GObjectFromWrapper (info.This ());
+    GObject *gobject = GObjectFromWrapperChecked (info.This ());
 
-    if (!gobject) {
-        Nan::ThrowTypeError("Object is not a GObject");
+    if (!gobject)
         return;
-    }
 
     if (!info[0]->IsString()) {
         Nan::ThrowTypeError("Signal ID invalid");
@@ -269,33 +746,29 @@ static void SignalConnectInternal(const Nan::FunctionCallbackInfo<v8::Value> &in
         return;
     }
 
-    const char *signal_name = *Nan::Utf8String (TO_STRING (info[0]));
+    Nan::Utf8String signal_name_utf8 (TO_STRING (info[0]));
+    const char *signal_name = *signal_name_utf8;
     Local<Function> callback = info[1].As<Function>();
-    GType gtype = (GType) TO_LONG (Nan::Get(info.This(), UTF8("__gtype__")).ToLocalChecked());
 
-    GIBaseInfo *object_info = g_irepository_find_by_gtype (NULL, gtype);
+    GIBaseInfo *object_info = GetIntrospectedObjectInfo (G_OBJECT_TYPE (gobject));
     GISignalInfo *signal_info = FindSignalInfo (object_info, signal_name);
 
     if (signal_info == NULL) {
         ThrowSignalNotFound(object_info, signal_name);
     }
     else {
-        GClosure *gclosure = MakeClosure (callback, signal_info);
+        GClosure *gclosure = MakeClosure (callback, signal_info, info.This ());
         ulong handler_id = g_signal_connect_closure (gobject, signal_name, gclosure, after);
 
         info.GetReturnValue().Set((double)handler_id);
     }
-
-    g_base_info_unref(object_info);
 }
 
 static void SignalDisconnectInternal(const Nan::FunctionCallbackInfo<v8::Value> &info) {
-    GObject *gobject = GObjectFromWrapper (info.This ());
+    GObject *gobject = GObjectFromWrapperChecked (info.This ());
 
-    if (!gobject) {
-        Nan::ThrowTypeError("Object is not a GObject");
+    if (!gobject)
         return;
-    }
 
     if (!info[0]->IsNumber()) {
         Nan::ThrowTypeError("Signal ID should be a number");
@@ -317,27 +790,164 @@ NAN_METHOD(SignalDisconnect) {
     SignalDisconnectInternal(info);
 }
 
+static GParamSpec* GetPlanParamSpec(PropertyPlan *plan, guint i, GObject *gobject) {
+    GParamSpec *pspec = plan->pspecs[i];
+
+    if (pspec == NULL) {
+        Nan::Utf8String key (Nan::New (plan->keys[i]));
+        char *message = g_strdup_printf ("%s has no property \"%s\"",
+                G_OBJECT_TYPE_NAME (gobject), *key);
+        Nan::ThrowError (message);
+        g_free (message);
+    }
+
+    return pspec;
+}
+
+/*
+ * obj.setProperties({ ... }): sets all properties with one notify transaction
+ */
+NAN_METHOD(GObjectSetProperties) {
+    GObject *gobject = GObjectFromWrapperChecked (info.This ());
+
+    if (gobject == NULL)
+        return;
+
+    if (!info[0]->IsObject ()) {
+        Nan::ThrowTypeError("Expected an object of properties");
+        return;
+    }
+
+    Local<Object> property_hash = TO_OBJECT (info[0]);
+    Local<Array> keys = Nan::GetOwnPropertyNames (property_hash).ToLocalChecked();
+    PropertyPlan *plan = GetPropertyPlan (G_OBJECT_TYPE (gobject), keys);
+
+    for (guint i = 0; i < plan->n_keys; i++) {
+        if (GetPlanParamSpec (plan, i, gobject) == NULL) {
+            PropertyPlanUnref (plan);
+            return;
+        }
+    }
+
+    PropertyValues props (plan->n_keys);
+    int n_values = InitGValuesFromPlan (plan, property_hash, props.names, props.values);
+
+    // Error will already be thrown from InitGValuesFromPlan
+    if (n_values < 0) {
+        PropertyPlanUnref (plan);
+        return;
+    }
+
+    props.n_values = n_values;
+
+    BatchNotifyTouch (gobject);
+    InvalidatePropertyCache (gobject, NULL);
+
+    g_object_freeze_notify (gobject);
+    g_object_setv (gobject, n_values, props.names, props.values);
+    g_object_thaw_notify (gobject);
+
+    PropertyPlanUnref (plan);
+}
+
+/*
+ * obj.getProperties([ ... ]): returns an object of the properties' values
+ */
+NAN_METHOD(GObjectGetProperties) {
+    GObject *gobject = GObjectFromWrapperChecked (info.This ());
+
+    if (gobject == NULL)
+        return;
+
+    if (!info[0]->IsArray ()) {
+        Nan::ThrowTypeError("Expected an array of property names");
+        return;
+    }
+
+    PropertyPlan *plan = GetPropertyPlan (G_OBJECT_TYPE (gobject), info[0].As<Array>());
+    Local<Object> result = New<Object> ();
+
+    for (guint i = 0; i < plan->n_keys; i++) {
+        GParamSpec *pspec = GetPlanParamSpec (plan, i, gobject);
+
+        if (pspec == NULL) {
+            PropertyPlanUnref (plan);
+            return;
+        }
+
+        GValue value = G_VALUE_INIT;
+        g_value_init (&value, G_PARAM_SPEC_VALUE_TYPE (pspec));
+        GetObjectProperty (gobject, pspec, &value);
+
+        Nan::Set (result, Nan::New (plan->keys[i]), GValueToV8 (&value));
+        g_value_unset (&value);
+    }
+
+    PropertyPlanUnref (plan);
+
+    info.GetReturnValue().Set(result);
+}
+
 NAN_METHOD(GObjectToString) {
     Local<Object> self = info.This();
 
-    if (!ValueHasInternalField(self)) {
+    if (!ValueIsGObject(self)) {
         Nan::ThrowTypeError("Object is not a GObject");
         return;
     }
 
     GObject* g_object = GObjectFromWrapper(self);
-    GType type = G_OBJECT_TYPE (g_object);
+    Nan::Utf8String className (self->GetConstructorName());
+    char *str;
 
-    const char* typeName = g_type_name(type);
-    char *className = *Nan::Utf8String(self->GetConstructorName());
-    void *address = self->GetAlignedPointerFromInternalField(0);
-
-    char *str = g_strdup_printf("[%s:%s %#zx]", typeName, className, (unsigned long)address);
+    if (g_object == NULL)
+        str = g_strdup_printf("[%s (disposed)]", *className);
+    else
+        str = g_strdup_printf("[%s:%s %#zx]",
+                G_OBJECT_TYPE_NAME (g_object), *className, (gsize) g_object);
 
     info.GetReturnValue().Set(UTF8(str));
     g_free(str);
 }
 
+/*
+ * obj.dispose(): releases the wrapper's reference to the object now, instead
+ * of when the wrapper is collected, and disconnects its JS handlers. The
+ * wrapper can't be used afterwards.
+ */
+NAN_METHOD(GObjectDispose) {
+    Local<Object> self = info.This();
+
+    if (!ValueIsGObject(self)) {
+        Nan::ThrowTypeError("Object is not a GObject");
+        return;
+    }
+
+    GObject *gobject = GObjectFromWrapper (self);
+
+    // Already disposed
+    if (gobject == NULL)
+        return;
+
+    DisposeGObject (self, gobject);
+}
+
+
+/*
+ * __gtype__ lives on the base prototype rather than on each instance, so that
+ * all wrappers of a class share the same shape. It is the runtime type.
+ */
+NAN_METHOD(GObjectGetGType) {
+    GObject *gobject = GObjectFromWrapper (info.This ());
+
+    if (gobject == NULL) {
+        info.GetReturnValue().SetUndefined();
+        return;
+    }
+
+    info.GetReturnValue().Set((double) G_OBJECT_TYPE (gobject));
+}
+
 Local<FunctionTemplate> GetBaseClassTemplate() {
     static bool isBaseClassCreated = false;
 
@@ -348,6 +958,14 @@ Local<FunctionTemplate> GetBaseClassTemplate() {
         Nan::SetPrototypeMethod(tpl, "connect", SignalConnect);
         Nan::SetPrototypeMethod(tpl, "disconnect", SignalDisconnect);
         Nan::SetPrototypeMethod(tpl, "toString", GObjectToString);
+        Nan::SetPrototypeMethod(tpl, "dispose", GObjectDispose);
+        Nan::SetPrototypeMethod(tpl, "setProperties", GObjectSetProperties);
+        Nan::SetPrototypeMethod(tpl, "getProperties", GObjectGetProperties);
+        tpl->PrototypeTemplate()->SetAccessorProperty(
+                UTF8("__gtype__"),
+                Nan::New<FunctionTemplate>(GObjectGetGType),
+                Local<FunctionTemplate>(),
+                (v8::PropertyAttribute)(v8::PropertyAttribute::ReadOnly | v8::PropertyAttribute::DontEnum));
         baseTemplate.Reset(tpl);
     }
 
@@ -407,11 +1025,29 @@ static Local<FunctionTemplate> GetClassTemplateFromGI(GIBaseInfo *info) {
 }
 
 Local<Function> MakeClass(GIBaseInfo *info) {
-    auto tpl = GetClassTemplateFromGI (info);
-    return Nan::GetFunction (tpl).ToLocalChecked();
+    GType gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) info);
+    void *data = g_type_get_qdata (gtype, GNodeJS::function_quark());
+
+    if (data) {
+        auto *persistent = (Persistent<Function> *) data;
+        return New<Function> (*persistent);
+    }
+
+    auto tpl = GetClassTemplate (info, gtype);
+    Local<Function> fn = Nan::GetFunction (tpl).ToLocalChecked();
+
+    auto *persistent = new Persistent<Function>(Isolate::GetCurrent(), fn);
+    g_type_set_qdata(gtype, GNodeJS::function_quark(), persistent);
+
+    return fn;
 }
 
-Local<Value> WrapperFromGObject(GObject *gobject, GIBaseInfo *object_info) {
+/*
+ * Returns the wrapper of @gobject, creating it if needed. The wrapper's class
+ * is the most-derived introspected class of its runtime type, not the static
+ * type of the value (which may be a parent class or an interface).
+ */
+Local<Value> WrapperFromGObject(GObject *gobject) {
     if (gobject == NULL)
         return Nan::Null();
 
@@ -424,20 +1060,22 @@ Local<Value> WrapperFromGObject(GObject *gobject, GIBaseInfo *object_info) {
         return obj;
 
     } else {
-        GType gtype = G_OBJECT_TYPE(gobject);
-        g_type_ensure (gtype); //void *klass = g_type_class_ref (type);
-        // We don't use the gtype above, but maybe we can register that type using the type's interface's object_info.
+        GIBaseInfo *object_info = GetIntrospectedObjectInfo (G_OBJECT_TYPE (gobject));
 
+        /* Instantiate the template directly: no constructor call, and no
+         * per-instance properties, so all wrappers of a class share a shape */
         auto tpl = GetClassTemplateFromGI(object_info);
-        Local<Function> constructor = Nan::GetFunction (tpl).ToLocalChecked();
-        Local<Value> gobject_external = New<External> (gobject);
-        Local<Value> args[] = { gobject_external };
-        Local<Object> obj = Nan::NewInstance(constructor, 1, args).ToLocalChecked();
+        Local<Object> obj = Nan::NewInstance (tpl->InstanceTemplate()).ToLocalChecked();
+        AssociateGObject (Isolate::GetCurrent(), obj, gobject);
 
         return obj;
     }
 }
 
+bool ValueIsGObject(Local<Value> value) {
+    return ValueHasInternalField(value) && GetBaseClassTemplate()->HasInstance(value);
+}
+
 GObject * GObjectFromWrapper(Local<Value> value) {
     if (!ValueHasInternalField(value))
         return nullptr;
@@ -449,4 +1087,319 @@ GObject * GObjectFromWrapper(Local<Value> value) {
     return gobject;
 }
 
+/*
+ * Property value cache: opt-in per class (see SetPropertyCache), for
+ * properties read much more often than they are written. The last converted
+ * value is kept per object and dropped on `notify`, so it is only correct for
+ * properties that notify reliably. Only primitive values are cached.
+ */
+
+#define PROPERTY_CACHE_ENABLED  1
+#define PROPERTY_CACHE_DISABLED 2
+
+struct PropertyCache {
+    GHashTable *values;         /* interned name => Nan::Persistent<Value> */
+    GThread    *thread;
+    gint        stale;          /* set by notify emitted from other threads */
+};
+
+/* GType => (interned name => PROPERTY_CACHE_ENABLED|DISABLED) */
+static GHashTable *propertyCacheClasses = NULL;
+/* Incremented on configuration changes, to invalidate accessors */
+static guint       propertyCacheEpoch = 0;
+
+static void DeleteCachedValue(gpointer data) {
+    delete (Nan::Persistent<Value> *) data;
+}
+
+static void PropertyCacheFree(gpointer data) {
+    auto *cache = (PropertyCache *) data;
+    g_hash_table_destroy (cache->values);
+    g_free (cache);
+}
+
+static void PropertyCacheNotify(GObject *gobject, GParamSpec *pspec, gpointer user_data) {
+    auto *cache = (PropertyCache *) user_data;
+
+    if (G_UNLIKELY (cache->thread != g_thread_self ())) {
+        g_atomic_int_set (&cache->stale, TRUE);
+        return;
+    }
+
+    g_hash_table_remove (cache->values, g_intern_string (pspec->name));
+}
+
+static PropertyCache* GetPropertyCache(GObject *gobject) {
+    auto *cache = (PropertyCache *) g_object_get_qdata (gobject, GNodeJS::property_cache_quark());
+
+    if (G_LIKELY (cache != NULL)) {
+        if (G_UNLIKELY (g_atomic_int_get (&cache->stale))) {
+            g_atomic_int_set (&cache->stale, FALSE);
+            g_hash_table_remove_all (cache->values);
+        }
+        return cache;
+    }
+
+    cache = g_new0 (PropertyCache, 1);
+    cache->values = g_hash_table_new_full (NULL, NULL, NULL, DeleteCachedValue);
+    cache->thread = g_thread_self ();
+
+    /* No destroy notifier: the object may be finalized on another thread,
+     * where the values can't be released. See ReleasePropertyCache. */
+    g_object_set_qdata (gobject, GNodeJS::property_cache_quark(), cache);
+    g_signal_connect (gobject, "notify", G_CALLBACK (PropertyCacheNotify), cache);
+
+    return cache;
+}
+
+/*
+ * Frees the cache of @gobject when its wrapper goes away, on the main thread
+ */
+static void ReleasePropertyCache(GObject *gobject) {
+    auto *cache = (PropertyCache *) g_object_steal_qdata (gobject, GNodeJS::property_cache_quark());
+
+    if (cache == NULL)
+        return;
+
+    g_signal_handlers_disconnect_by_func (gobject, (gpointer) PropertyCacheNotify, cache);
+    PropertyCacheFree (cache);
+}
+
+static void InvalidatePropertyCache(GObject *gobject, const char *name) {
+    auto *cache = (PropertyCache *) g_object_get_qdata (gobject, GNodeJS::property_cache_quark());
+
+    if (cache == NULL)
+        return;
+
+    if (name == NULL)
+        g_hash_table_remove_all (cache->values);
+    else
+        g_hash_table_remove (cache->values, name);
+}
+
+static bool IsPropertyCached(GType gtype, const char *name) {
+    if (propertyCacheClasses == NULL)
+        return false;
+
+    for (; gtype != G_TYPE_INVALID; gtype = g_type_parent (gtype)) {
+        auto *names = (GHashTable *) g_hash_table_lookup (propertyCacheClasses, GSIZE_TO_POINTER (gtype));
+        if (names == NULL)
+            continue;
+
+        int state = GPOINTER_TO_INT (g_hash_table_lookup (names, name));
+        if (state != 0)
+            return state == PROPERTY_CACHE_ENABLED;
+    }
+
+    return false;
+}
+
+/*
+ * Enables or disables value caching of the properties @names for instances
+ * of @gtype (and subclasses, unless they override it).
+ */
+bool SetPropertyCache(GType gtype, Local<Array> names, bool enabled) {
+    if (!g_type_is_a (gtype, G_TYPE_OBJECT)) {
+        Nan::ThrowTypeError("Expected a GObject class");
+        return false;
+    }
+
+    if (propertyCacheClasses == NULL)
+        propertyCacheClasses = g_hash_table_new (NULL, NULL);
+
+    /* Kept alive, like the configuration */
+    GObjectClass *klass = (GObjectClass *) g_type_class_ref (gtype);
+    auto *table = (GHashTable *) g_hash_table_lookup (propertyCacheClasses, GSIZE_TO_POINTER (gtype));
+
+    if (table == NULL) {
+        table = g_hash_table_new (NULL, NULL);
+        g_hash_table_insert (propertyCacheClasses, GSIZE_TO_POINTER (gtype), table);
+    }
+
+    for (uint32_t i = 0; i < names->Length(); i++) {
+        Nan::Utf8String key (Nan::Get (names, i).ToLocalChecked());
+        GParamSpec *pspec = FindPropertyByKey (klass, *key);
+
+        if (pspec == NULL) {
+            char *message = g_strdup_printf ("%s has no property \"%s\"", g_type_name (gtype), *key);
+            Nan::ThrowError (message);
+            g_free (message);
+            return false;
+        }
+
+        g_hash_table_insert (table, (gpointer) g_intern_string (pspec->name),
+                GINT_TO_POINTER (enabled ? PROPERTY_CACHE_ENABLED : PROPERTY_CACHE_DISABLED));
+    }
+
+    propertyCacheEpoch++;
+
+    return true;
+}
+
+
+/*
+ * Property accessors: native getter & setter functions bound to one property.
+ * The GParamSpec is resolved once, from the class or interface declaring the
+ * property, so that accessing a property doesn't look it up by name each time.
+ */
+
+struct PropertyAccessor {
+    const char   *name;         /* interned */
+    GType         owner_type;   /* the declaring class or interface */
+    GParamSpec   *pspec;
+    const char   *key;          /* interned pspec name, for the value cache */
+    GType         cached_type;  /* the last type IsPropertyCached was checked for */
+    bool          cached;
+    guint         cached_epoch;
+};
+
+static GParamSpec* GetAccessorParamSpec(PropertyAccessor *accessor, GObject *gobject) {
+    if (G_UNLIKELY (!g_type_is_a (G_OBJECT_TYPE (gobject), accessor->owner_type))) {
+        char *message = g_strdup_printf ("Object is not a %s", g_type_name (accessor->owner_type));
+        Nan::ThrowTypeError (message);
+        g_free (message);
+        return NULL;
+    }
+
+    if (G_UNLIKELY (accessor->pspec == NULL)) {
+        /* The class (or interface) is kept alive as long as we point to its pspec */
+        if (G_TYPE_IS_INTERFACE (accessor->owner_type)) {
+            gpointer iface = g_type_default_interface_ref (accessor->owner_type);
+            accessor->pspec = g_object_interface_find_property (iface, accessor->name);
+        } else {
+            GObjectClass *klass = (GObjectClass *) g_type_class_ref (accessor->owner_type);
+            accessor->pspec = g_object_class_find_property (klass, accessor->name);
+        }
+
+        if (accessor->pspec == NULL) {
+            char *message = g_strdup_printf ("%s has no property \"%s\"",
+                    g_type_name (accessor->owner_type), accessor->name);
+            Nan::ThrowError (message);
+            g_free (message);
+            return NULL;
+        }
+
+        accessor->key = g_intern_string (accessor->pspec->name);
+    }
+
+    /* Caching is configured per class, and subclasses can override it */
+    GType gtype = G_OBJECT_TYPE (gobject);
+    if (G_UNLIKELY (gtype != accessor->cached_type || accessor->cached_epoch != propertyCacheEpoch)) {
+        accessor->cached = IsPropertyCached (gtype, accessor->key);
+        accessor->cached_type = gtype;
+        accessor->cached_epoch = propertyCacheEpoch;
+    }
+
+    return accessor->pspec;
+}
+
+/*
+ * Same as g_object_get_property(), without the name lookup when the property
+ * is installed by the object's own class.
+ */
+static void GetObjectProperty(GObject *gobject, GParamSpec *pspec, GValue *value) {
+    if (G_LIKELY (G_OBJECT_TYPE (gobject) == pspec->owner_type
+                && (pspec->flags & G_PARAM_READABLE) != 0)) {
+        GObjectClass *klass = G_OBJECT_GET_CLASS (gobject);
+        GParamSpec *target = g_param_spec_get_redirect_target (pspec);
+        klass->get_property (gobject, pspec->param_id, value, target ? target : pspec);
+        return;
+    }
+
+    g_object_get_property (gobject, pspec->name, value);
+}
+
+static void PropertyGetter(const Nan::FunctionCallbackInfo<Value> &info) {
+    auto *accessor = (PropertyAccessor *) External::Cast (*info.Data ())->Value ();
+    GObject *gobject = GObjectFromWrapperChecked (info.This ());
+
+    if (gobject == NULL)
+        return;
+
+    GParamSpec *pspec = GetAccessorParamSpec (accessor, gobject);
+
+    // Error will already be thrown from GetAccessorParamSpec
+    if (pspec == NULL)
+        return;
+
+    PropertyCache *cache = NULL;
+
+    if (accessor->cached && !IsBatchFrozen (gobject)) {
+        cache = GetPropertyCache (gobject);
+        auto *cached = (Nan::Persistent<Value> *) g_hash_table_lookup (cache->values, accessor->key);
+
+        if (cached != NULL) {
+            info.GetReturnValue().Set(Nan::New (*cached));
+            return;
+        }
+    }
+
+    GValue value = G_VALUE_INIT;
+    g_value_init (&value, G_PARAM_SPEC_VALUE_TYPE (pspec));
+    GetObjectProperty (gobject, pspec, &value);
+
+    Local<Value> result = GValueToV8 (&value);
+    g_value_unset (&value);
+
+    if (cache != NULL && !result->IsObject ())
+        g_hash_table_insert (cache->values, (gpointer) accessor->key,
+                new Nan::Persistent<Value> (result));
+
+    info.GetReturnValue().Set(result);
+}
+
+static void PropertySetter(const Nan::FunctionCallbackInfo<Value> &info) {
+    auto *accessor = (PropertyAccessor *) External::Cast (*info.Data ())->Value ();
+    GObject *gobject = GObjectFromWrapperChecked (info.This ());
+
+    if (gobject == NULL)
+        return;
+
+    GParamSpec *pspec = GetAccessorParamSpec (accessor, gobject);
+
+    // Error will already be thrown from GetAccessorParamSpec
+    if (pspec == NULL)
+        return;
+
+    GValue value = G_VALUE_INIT;
+    g_value_init (&value, G_PARAM_SPEC_VALUE_TYPE (pspec));
+
+    if (V8ToGValue (&value, info[0])) {
+        BatchNotifyTouch (gobject);
+        /* notify may be frozen, or not emitted at all */
+        if (accessor->cached)
+            InvalidatePropertyCache (gobject, accessor->key);
+        /* Holds a ref & freezes notify around the class setter, which may
+         * notify itself */
+        g_object_set_property (gobject, pspec->name, &value);
+    }
+    else
+        Nan::ThrowError("PropertySetter: could not convert value");
+
+    g_value_unset (&value);
+}
+
+/*
+ * Returns { get, set } native functions for the property @prop_info.
+ * Accessors live as long as the process, like the classes.
+ */
+Local<Object> MakePropertyAccessors(GIPropertyInfo *prop_info) {
+    GIBaseInfo *container = g_base_info_get_container (prop_info);
+
+    auto *accessor = g_new0 (PropertyAccessor, 1);
+    accessor->name = g_intern_string (g_base_info_get_name (prop_info));
+    accessor->owner_type = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) container);
+    accessor->cached_type = G_TYPE_INVALID;
+
+    Local<External> data = New<External> (accessor);
+    Local<Function> getter = Nan::GetFunction (New<FunctionTemplate> (PropertyGetter, data)).ToLocalChecked();
+    Local<Function> setter = Nan::GetFunction (New<FunctionTemplate> (PropertySetter, data)).ToLocalChecked();
+
+    Local<Object> result = New<Object> ();
+    Nan::Set (result, UTF8("get"), getter);
+    Nan::Set (result, UTF8("set"), setter);
+
+    return result;
+}
+
 };
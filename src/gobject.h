@@ -15,8 +15,19 @@ using v8::Value;
 namespace GNodeJS {
 
 Local<Function>         MakeClass            (GIBaseInfo *info);
-Local<Value>            WrapperFromGObject   (GObject *object, GIBaseInfo *info = NULL);
+Local<Value>            WrapperFromGObject   (GObject *object);
 GObject *               GObjectFromWrapper   (Local<Value> value);
 Local<FunctionTemplate> GetBaseClassTemplate ();
+bool                    ValueIsGObject       (Local<Value> value);
+Local<v8::Object>       MakePropertyAccessors (GIPropertyInfo *prop_info);
+void                    ForgetParentObjectInfos ();
+
+void                    BatchNotifyBegin     ();
+void                    BatchNotifyEnd       ();
+
+bool                    SetPropertyCache     (GType gtype, Local<v8::Array> names, bool enabled);
+
+void                    DrainToggleQueue     ();
+void                    GetToggleStats       (guint64 *applied, guint64 *coalesced, guint *pending);
 
 };
@@ -0,0 +1,197 @@
+/*
+ * heap_graph.cc
+ *
+ * Adds the native side of wrappers to heap snapshots: GObjects, boxed
+ * payloads, signal closures and callbacks appear as nodes with their native
+ * size & type name, linked to their wrappers and to the functions they hold.
+ *
+ * The live sets are maintained where wrappers are associated & destroyed, so
+ * building the graph doesn't have to scan anything.
+ */
+
+#include <memory>
+#include <nan.h>
+#include <v8-profiler.h>
+
+#include "boxed.h"
+#include "callback.h"
+#include "closure.h"
+#include "gi.h"
+#include "gobject.h"
+#include "heap_graph.h"
+
+using v8::EmbedderGraph;
+using v8::HandleScope;
+using v8::Isolate;
+using v8::Local;
+using v8::Object;
+using v8::Value;
+
+namespace GNodeJS {
+
+static GHashTable *liveGObjects  = g_hash_table_new (NULL, NULL);
+static GHashTable *liveBoxed     = g_hash_table_new (NULL, NULL);
+static GHashTable *liveClosures  = g_hash_table_new (NULL, NULL);
+static GHashTable *liveCallbacks = g_hash_table_new (NULL, NULL);
+
+/* Closures can be invalidated from other threads */
+G_LOCK_DEFINE_STATIC (liveSets);
+
+class NativeNode : public EmbedderGraph::Node {
+public:
+    NativeNode (char *name, size_t size) : name (name), size (size) {}
+    ~NativeNode () override { g_free (name); }
+
+    const char* Name () override { return name; }
+    size_t SizeInBytes () override { return size; }
+
+private:
+    char  *name;
+    size_t size;
+};
+
+static EmbedderGraph::Node* AddNativeNode (EmbedderGraph *graph, char *name, size_t size) {
+    return graph->AddNode (std::unique_ptr<EmbedderGraph::Node> (new NativeNode (name, size)));
+}
+
+static EmbedderGraph::Node* AddV8Node (EmbedderGraph *graph, Local<Value> value) {
+    return graph->V8Node (value);
+}
+
+static void BuildEmbedderGraph (Isolate *isolate, EmbedderGraph *graph, void *data) {
+    HandleScope scope (isolate);
+
+    /* GObject -> node, for the edges of the closures connected to them */
+    GHashTable *gobjectNodes = g_hash_table_new (NULL, NULL);
+    GHashTableIter iter;
+    gpointer key;
+
+    G_LOCK (liveSets);
+
+    g_hash_table_iter_init (&iter, liveGObjects);
+    while (g_hash_table_iter_next (&iter, &key, NULL)) {
+        GObject *gobject = G_OBJECT (key);
+        auto *persistent = (v8::Persistent<Object> *) g_object_get_qdata (gobject, GNodeJS::object_quark());
+
+        if (persistent == NULL)
+            continue;
+
+        gsize size = GPOINTER_TO_SIZE (g_object_get_qdata (gobject, GNodeJS::external_size_quark()));
+        auto *node = AddNativeNode (graph,
+                g_strdup_printf ("GObject %s", G_OBJECT_TYPE_NAME (gobject)), size);
+        auto *wrapper = AddV8Node (graph, Nan::New (*persistent));
+
+        graph->AddEdge (wrapper, node);
+
+        /* The toggle ref: other native holders keep the wrapper alive */
+        if (!persistent->IsWeak ())
+            graph->AddEdge (node, wrapper);
+
+        g_hash_table_insert (gobjectNodes, gobject, node);
+    }
+
+    g_hash_table_iter_init (&iter, liveBoxed);
+    while (g_hash_table_iter_next (&iter, &key, NULL)) {
+        Boxed *box = (Boxed *) key;
+
+        if (box->persistent == NULL)
+            continue;
+
+        auto *node = AddNativeNode (graph,
+                g_strdup_printf ("Boxed %s.%s",
+                    g_base_info_get_namespace (box->info), g_base_info_get_name (box->info)),
+                box->external_size);
+
+        graph->AddEdge (AddV8Node (graph, Nan::New (*box->persistent)), node);
+    }
+
+    g_hash_table_iter_init (&iter, liveClosures);
+    while (g_hash_table_iter_next (&iter, &key, NULL)) {
+        Closure *closure = (Closure *) key;
+
+        auto *node = AddNativeNode (graph,
+                g_strdup_printf ("GClosure %s", g_base_info_get_name (closure->info)),
+                sizeof (Closure));
+
+        /* The instance the closure is connected to holds it */
+        if (!closure->owner.IsEmpty ()) {
+            GObject *gobject = GObjectFromWrapper (Nan::New (closure->owner));
+            auto *owner_node = (EmbedderGraph::Node *) g_hash_table_lookup (gobjectNodes, gobject);
+            if (owner_node != NULL)
+                graph->AddEdge (owner_node, node);
+        }
+
+        if (!closure->persistent.IsEmpty ())
+            graph->AddEdge (node, AddV8Node (graph, Nan::New (closure->persistent)));
+    }
+
+    g_hash_table_iter_init (&iter, liveCallbacks);
+    while (g_hash_table_iter_next (&iter, &key, NULL)) {
+        Callback *callback = (Callback *) key;
+
+        auto *node = AddNativeNode (graph,
+                g_strdup_printf ("Callback %s", g_base_info_get_name (callback->info)),
+                sizeof (Callback));
+
+        if (!callback->persistent.IsEmpty ())
+            graph->AddEdge (node, AddV8Node (graph, Nan::New (callback->persistent)));
+    }
+
+    G_UNLOCK (liveSets);
+
+    g_hash_table_unref (gobjectNodes);
+}
+
+void HeapGraphAddGObject (GObject *gobject) {
+    G_LOCK (liveSets);
+    g_hash_table_add (liveGObjects, gobject);
+    G_UNLOCK (liveSets);
+}
+
+void HeapGraphRemoveGObject (GObject *gobject) {
+    G_LOCK (liveSets);
+    g_hash_table_remove (liveGObjects, gobject);
+    G_UNLOCK (liveSets);
+}
+
+void HeapGraphAddBoxed (Boxed *box) {
+    G_LOCK (liveSets);
+    g_hash_table_add (liveBoxed, box);
+    G_UNLOCK (liveSets);
+}
+
+void HeapGraphRemoveBoxed (Boxed *box) {
+    G_LOCK (liveSets);
+    g_hash_table_remove (liveBoxed, box);
+    G_UNLOCK (liveSets);
+}
+
+void HeapGraphAddClosure (Closure *closure) {
+    G_LOCK (liveSets);
+    g_hash_table_add (liveClosures, closure);
+    G_UNLOCK (liveSets);
+}
+
+void HeapGraphRemoveClosure (Closure *closure) {
+    G_LOCK (liveSets);
+    g_hash_table_remove (liveClosures, closure);
+    G_UNLOCK (liveSets);
+}
+
+void HeapGraphAddCallback (Callback *callback) {
+    G_LOCK (liveSets);
+    g_hash_table_add (liveCallbacks, callback);
+    G_UNLOCK (liveSets);
+}
+
+void HeapGraphRemoveCallback (Callback *callback) {
+    G_LOCK (liveSets);
+    g_hash_table_remove (liveCallbacks, callback);
+    G_UNLOCK (liveSets);
+}
+
+void StartHeapGraph () {
+    Isolate::GetCurrent ()->AddBuildEmbedderGraphCallback (BuildEmbedderGraph, NULL);
+}
+
+};
@@ -0,0 +1,26 @@
+
+#pragma once
+
+#include <glib-object.h>
+
+namespace GNodeJS {
+
+  struct Callback;
+  struct Closure;
+  class  Boxed;
+
+  void  HeapGraphAddGObject (GObject *gobject);
+  void  HeapGraphRemoveGObject (GObject *gobject);
+
+  void  HeapGraphAddBoxed (Boxed *box);
+  void  HeapGraphRemoveBoxed (Boxed *box);
+
+  void  HeapGraphAddClosure (Closure *closure);
+  void  HeapGraphRemoveClosure (Closure *closure);
+
+  void  HeapGraphAddCallback (Callback *callback);
+  void  HeapGraphRemoveCallback (Callback *callback);
+
+  void  StartHeapGraph ();
+
+};
@@ -5,6 +5,7 @@
 
 #include "debug.h"
 #include "gi.h"
+#include "gobject.h"
 #include "loop.h"
 #include "macros.h"
 #include "util.h"
@@ -32,6 +33,8 @@ static gboolean loop_source_prepare (GSource *base, int *timeout) {
     struct uv_loop_source *source = (struct uv_loop_source *) base;
     uv_update_time (source->loop);
 
+    DrainToggleQueue ();
+
     bool loop_alive = uv_loop_alive (source->loop);
 
     /* If the loop is dead, we can simply sleep forever until a GTK+ source
@@ -116,6 +119,34 @@ void StartLoop() {
     g_source_attach (source, NULL);
 }
 
+/*
+ * Runs the deferred work of each uv iteration, for when the GLib loop isn't
+ * running (it drains the same queues in loop_source_prepare otherwise).
+ */
+static void loop_check_cb (uv_check_t *handle) {
+    DrainToggleQueue ();
+}
+
+/*
+ * Wrappers created by synchronous code only become weak once their toggle
+ * down is applied: do it before each collection, so they can be collected
+ * before the loop runs again.
+ */
+static void gc_prologue_cb (Isolate *isolate, GCType type, GCCallbackFlags flags) {
+    DrainToggleQueue ();
+}
+
+void StartLoopHooks() {
+    static uv_check_t check;
+
+    uv_check_init (uv_default_loop (), &check);
+    uv_check_start (&check, loop_check_cb);
+    /* Doesn't keep the process alive */
+    uv_unref ((uv_handle_t *) &check);
+
+    Nan::AddGCPrologueCallback (gc_prologue_cb);
+}
+
 Local<Array> GetLoopStack() {
     return Nan::New<Array>(loopStack);
 }
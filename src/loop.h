@@ -12,6 +12,8 @@ namespace GNodeJS {
 
   void StartLoop();
 
+  void StartLoopHooks();
+
   void QuitLoopStack();
 
   Local<Array> GetLoopStack();
@@ -0,0 +1,174 @@
+/*
+ * memory.cc
+ *
+ * V8 only sees the size of a wrapper, not the native memory it keeps alive:
+ * a 50MB GdkPixbuf looks as small as a label. Wrappers report an estimate of
+ * their native size as external memory when they're associated, and reverse
+ * it when they're destroyed, so the GC runs as often as it should.
+ *
+ * The estimate is the instance (or struct) size, plus what a size estimator
+ * registered for the type (or one of its parents) returns for pixel buffers,
+ * byte arrays & co.
+ */
+
+#include <nan.h>
+#include <gmodule.h>
+#include <string.h>
+
+#include "memory.h"
+
+namespace GNodeJS {
+
+struct EstimatorEntry {
+    const char    *type_name;
+    SizeEstimator  estimator;
+};
+
+/* Registered estimators, by type name as their library may not be loaded yet */
+static GArray     *estimators       = NULL;
+/* GType -> SizeEstimator, including negative (NULL) lookups */
+static GHashTable *estimatorsByType = NULL;
+
+static gint64      externalMemory   = 0;
+
+
+static gsize EstimatePixbuf (gpointer instance) {
+    int rowstride = 0;
+    int height = 0;
+    g_object_get (instance, "rowstride", &rowstride, "height", &height, NULL);
+    return (gsize) rowstride * height;
+}
+
+static gsize EstimateBytes (gpointer instance) {
+    return g_bytes_get_size ((GBytes *) instance);
+}
+
+static gsize EstimateVariant (gpointer instance) {
+    return g_variant_get_size ((GVariant *) instance);
+}
+
+/* We don't link against cairo: the functions are looked up in the process,
+ * where they're available if anything returned a surface. */
+typedef int (*CairoSurfaceGetter) (gpointer surface);
+
+#define CAIRO_SURFACE_TYPE_IMAGE 0
+
+static gsize EstimateCairoSurface (gpointer instance) {
+    static bool resolved = false;
+    static CairoSurfaceGetter get_type   = NULL;
+    static CairoSurfaceGetter get_stride = NULL;
+    static CairoSurfaceGetter get_height = NULL;
+
+    if (!resolved) {
+        GModule *module = g_module_open (NULL, (GModuleFlags) 0);
+        if (module != NULL) {
+            g_module_symbol (module, "cairo_surface_get_type",        (gpointer *) &get_type);
+            g_module_symbol (module, "cairo_image_surface_get_stride", (gpointer *) &get_stride);
+            g_module_symbol (module, "cairo_image_surface_get_height", (gpointer *) &get_height);
+        }
+        resolved = true;
+    }
+
+    if (get_type == NULL || get_stride == NULL || get_height == NULL)
+        return 0;
+
+    if (get_type (instance) != CAIRO_SURFACE_TYPE_IMAGE)
+        return 0;
+
+    return (gsize) get_stride (instance) * get_height (instance);
+}
+
+static void InitEstimators () {
+    estimators = g_array_new (FALSE, FALSE, sizeof (EstimatorEntry));
+    estimatorsByType = g_hash_table_new (NULL, NULL);
+
+    RegisterSizeEstimator ("GdkPixbuf",    EstimatePixbuf);
+    RegisterSizeEstimator ("GBytes",       EstimateBytes);
+    RegisterSizeEstimator ("GVariant",     EstimateVariant);
+    RegisterSizeEstimator ("CairoSurface", EstimateCairoSurface);
+}
+
+static SizeEstimator FindEstimator (GType gtype) {
+    if (G_UNLIKELY (estimators == NULL))
+        InitEstimators ();
+
+    gpointer result;
+    if (g_hash_table_lookup_extended (estimatorsByType, GSIZE_TO_POINTER (gtype), NULL, &result))
+        return (SizeEstimator) result;
+
+    SizeEstimator estimator = NULL;
+
+    for (GType type = gtype; type != 0 && estimator == NULL; type = g_type_parent (type)) {
+        const char *type_name = g_type_name (type);
+
+        for (guint i = 0; i < estimators->len; i++) {
+            auto *entry = &g_array_index (estimators, EstimatorEntry, i);
+            if (strcmp (entry->type_name, type_name) == 0) {
+                estimator = entry->estimator;
+                break;
+            }
+        }
+    }
+
+    g_hash_table_insert (estimatorsByType, GSIZE_TO_POINTER (gtype), (gpointer) estimator);
+
+    return estimator;
+}
+
+/**
+ * Registers @estimator for the type named @type_name and its subtypes
+ */
+void RegisterSizeEstimator (const char *type_name, SizeEstimator estimator) {
+    if (G_UNLIKELY (estimators == NULL))
+        InitEstimators ();
+
+    EstimatorEntry entry = { type_name, estimator };
+    g_array_append_val (estimators, entry);
+    g_hash_table_remove_all (estimatorsByType);
+}
+
+gsize EstimateGObjectSize (GObject *gobject) {
+    GType gtype = G_OBJECT_TYPE (gobject);
+
+    GTypeQuery query;
+    g_type_query (gtype, &query);
+
+    gsize size = query.instance_size;
+
+    SizeEstimator estimator = FindEstimator (gtype);
+    if (estimator != NULL)
+        size += estimator (gobject);
+
+    return size;
+}
+
+/**
+ * @size: the size of the struct, if known
+ */
+gsize EstimateBoxedSize (GType gtype, gpointer data, gsize size) {
+    if (gtype == G_TYPE_NONE || data == NULL)
+        return size;
+
+    SizeEstimator estimator = FindEstimator (gtype);
+    if (estimator != NULL)
+        size += estimator (data);
+
+    return size;
+}
+
+/**
+ * Reports @change bytes of native memory held by wrappers to V8
+ */
+void AdjustExternalMemory (gint64 change) {
+    if (change == 0)
+        return;
+
+    externalMemory += change;
+    Nan::AdjustExternalMemory ((int) CLAMP (change, G_MININT, G_MAXINT));
+}
+
+gint64 GetExternalMemory () {
+    return externalMemory;
+}
+
+};
@@ -0,0 +1,21 @@
+
+#pragma once
+
+#include <glib.h>
+#include <glib-object.h>
+
+namespace GNodeJS {
+
+  typedef gsize (*SizeEstimator) (gpointer instance);
+
+  void   RegisterSizeEstimator (const char *type_name, SizeEstimator estimator);
+
+  gsize  EstimateGObjectSize (GObject *gobject);
+
+  gsize  EstimateBoxedSize (GType gtype, gpointer data, gsize size);
+
+  void   AdjustExternalMemory (gint64 change);
+
+  gint64 GetExternalMemory ();
+
+};
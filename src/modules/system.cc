@@ -6,9 +6,12 @@
 #include <glib-object.h>
 
 
+#include "../census.h"
+#include "../finalization.h"
 #include "../gi.h"
 #include "../gobject.h"
 #include "../macros.h"
+#include "../memory.h"
 #include "../value.h"
 #include "system.h"
 
@@ -43,6 +46,94 @@ NAN_METHOD(InternalFieldCount) {
     RETURN(obj->InternalFieldCount());
 }
 
+/*
+ * System.weakRef(object): returns a function telling if the object was
+ * finalized, without keeping it alive. The state is shared by the function and
+ * the GObject weak ref, and freed when both are gone.
+ */
+struct WeakRefState {
+    bool finalized;
+    int refs;
+    Nan::Persistent<v8::Function> function;
+};
+
+static void WeakRefStateUnref(WeakRefState *state) {
+    if (--state->refs == 0)
+        delete state;
+}
+
+static void WeakRefNotify(gpointer data, GObject *where_the_object_was) {
+    auto *state = (WeakRefState *) data;
+    state->finalized = true;
+    WeakRefStateUnref (state);
+}
+
+static void WeakRefFunctionCollected(const Nan::WeakCallbackInfo<WeakRefState> &data) {
+    WeakRefStateUnref (data.GetParameter ());
+}
+
+NAN_METHOD(IsFinalized) {
+    auto *state = (WeakRefState *) info.Data().As<v8::External>()->Value();
+    RETURN(Nan::New<v8::Boolean>(state->finalized));
+}
+
+NAN_METHOD(WeakRef) {
+    GObject *gobject = GObjectFromWrapper (info[0]);
+
+    if (gobject == NULL) {
+        Nan::ThrowTypeError("Expected a GObject");
+        return;
+    }
+
+    auto *state = new WeakRefState ();
+    state->finalized = false;
+    state->refs = 2;
+    g_object_weak_ref (gobject, WeakRefNotify, state);
+
+    auto function = Nan::New<v8::FunctionTemplate>(IsFinalized, Nan::New<v8::External>(state))
+        ->GetFunction(Nan::GetCurrentContext()).ToLocalChecked();
+    state->function.Reset (function);
+    state->function.SetWeak (state, WeakRefFunctionCollected, Nan::WeakCallbackType::kParameter);
+
+    RETURN(function);
+}
+
+NAN_METHOD(ToggleStats) {
+    guint64 applied, coalesced;
+    guint pending;
+    GetToggleStats (&applied, &coalesced, &pending);
+
+    auto result = Nan::New<Object>();
+    Nan::Set(result, UTF8("applied"),   Nan::New<v8::Number>((double) applied));
+    Nan::Set(result, UTF8("coalesced"), Nan::New<v8::Number>((double) coalesced));
+    Nan::Set(result, UTF8("pending"),   Nan::New<v8::Number>(pending));
+
+    RETURN(result);
+}
+
+NAN_METHOD(FinalizationStats) {
+    guint pending;
+    guint64 released;
+    gint64 last_drain_usec, max_latency_usec;
+    GetFinalizationStats (&pending, &released, &last_drain_usec, &max_latency_usec);
+
+    auto result = Nan::New<Object>();
+    Nan::Set(result, UTF8("pending"),        Nan::New<v8::Number>(pending));
+    Nan::Set(result, UTF8("released"),       Nan::New<v8::Number>((double) released));
+    Nan::Set(result, UTF8("lastDrainUsec"),  Nan::New<v8::Number>((double) last_drain_usec));
+    Nan::Set(result, UTF8("maxLatencyUsec"), Nan::New<v8::Number>((double) max_latency_usec));
+
+    RETURN(result);
+}
+
+NAN_METHOD(ExternalMemory) {
+    RETURN(Nan::New<v8::Number>((double) GetExternalMemory ()));
+}
+
+NAN_METHOD(Census) {
+    RETURN(GetCensus ());
+}
+
 NAN_METHOD(Breakpoint) {
     G_BREAKPOINT ();
 }
@@ -53,6 +144,11 @@ Local<Object> GetModule() {
     Nan::Export(exports, "addressOf", AddressOf);
     Nan::Export(exports, "refCount", RefCount);
     Nan::Export(exports, "internalFieldCount", InternalFieldCount);
+    Nan::Export(exports, "weakRef", WeakRef);
+    Nan::Export(exports, "toggleStats", ToggleStats);
+    Nan::Export(exports, "finalizationStats", FinalizationStats);
+    Nan::Export(exports, "externalMemory", ExternalMemory);
+    Nan::Export(exports, "census", Census);
     Nan::Export(exports, "breakpoint", Breakpoint);
 
     return exports;
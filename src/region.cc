@@ -0,0 +1,130 @@
+#include <glib.h>
+#include <string.h>
+#include <nan.h>
+
+#include "debug.h"
+#include "region.h"
+
+/*
+ * Regions back gi.withRegion(): boxed values allocated by us while a region
+ * is active come from a bump allocator, and are released in one shot when
+ * the region exits. Their wrappers are invalidated (internal field set to
+ * NULL), so that later accesses throw instead of touching freed memory.
+ */
+
+using v8::Array;
+
+namespace GNodeJS {
+
+#define REGION_CHUNK_SIZE 4096
+#define REGION_ALIGNMENT  16
+
+struct RegionChunk {
+    guint8 *data;
+    gsize   size;
+    gsize   used;
+};
+
+struct Region {
+    GSList *chunks; /* RegionChunk *, current one first */
+    Nan::Persistent<Array> wrappers;
+    uint32_t n_wrappers;
+};
+
+static GSList *regionStack = NULL; /* Region *, innermost first */
+
+void RegionEnter () {
+    Region *region = new Region();
+    region->chunks = NULL;
+    region->n_wrappers = 0;
+    regionStack = g_slist_prepend (regionStack, region);
+}
+
+void RegionExit () {
+    g_return_if_fail (regionStack != NULL);
+
+    Region *region = (Region *) regionStack->data;
+    regionStack = g_slist_delete_link (regionStack, regionStack);
+
+    if (!region->wrappers.IsEmpty ()) {
+        Local<Array> wrappers = Nan::New<Array> (region->wrappers);
+        for (uint32_t i = 0; i < region->n_wrappers; i++) {
+            Local<Object> wrapper = Nan::Get (wrappers, i).ToLocalChecked ().As<Object> ();
+            wrapper->SetAlignedPointerInInternalField (0, NULL);
+        }
+        region->wrappers.Reset ();
+    }
+
+    for (GSList *l = region->chunks; l != NULL; l = l->next) {
+        RegionChunk *chunk = (RegionChunk *) l->data;
+        g_free (chunk->data);
+        g_slice_free (RegionChunk, chunk);
+    }
+    g_slist_free (region->chunks);
+
+    delete region;
+}
+
+/**
+ * Allocates zeroed memory in the innermost region
+ * @returns the memory, or NULL if no region is active
+ */
+void* RegionAlloc (gsize size) {
+    if (regionStack == NULL)
+        return NULL;
+
+    Region *region = (Region *) regionStack->data;
+    RegionChunk *chunk = region->chunks ? (RegionChunk *) region->chunks->data : NULL;
+
+    size = (size + REGION_ALIGNMENT - 1) & ~(gsize) (REGION_ALIGNMENT - 1);
+
+    if (chunk == NULL || chunk->used + size > chunk->size) {
+        chunk = g_slice_new (RegionChunk);
+        chunk->size = MAX (size, REGION_CHUNK_SIZE);
+        chunk->used = 0;
+        chunk->data = (guint8 *) g_malloc0 (chunk->size);
+        region->chunks = g_slist_prepend (region->chunks, chunk);
+    }
+
+    void *pointer = chunk->data + chunk->used;
+    chunk->used += size;
+
+    return pointer;
+}
+
+static Region *FindRegion (void *pointer) {
+    for (GSList *r = regionStack; r != NULL; r = r->next) {
+        Region *region = (Region *) r->data;
+
+        for (GSList *l = region->chunks; l != NULL; l = l->next) {
+            RegionChunk *chunk = (RegionChunk *) l->data;
+            if ((guint8 *) pointer >= chunk->data && (guint8 *) pointer < chunk->data + chunk->used)
+                return region;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @returns true if @pointer was allocated in one of the active regions
+ */
+bool RegionContains (void *pointer) {
+    return regionStack != NULL && FindRegion (pointer) != NULL;
+}
+
+/**
+ * Registers a wrapper of region memory, to be invalidated when the region
+ * that contains @pointer exits
+ */
+void RegionTrack (Local<Object> wrapper, void *pointer) {
+    Region *region = FindRegion (pointer);
+
+    g_return_if_fail (region != NULL);
+
+    if (region->wrappers.IsEmpty ())
+        region->wrappers.Reset (Nan::New<Array> ());
+
+    Nan::Set (Nan::New<Array> (region->wrappers), region->n_wrappers++, wrapper);
+}
+
+};
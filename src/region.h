@@ -0,0 +1,23 @@
+
+#pragma once
+
+#include <nan.h>
+#include <v8.h>
+#include <glib.h>
+
+using v8::Local;
+using v8::Object;
+
+namespace GNodeJS {
+
+  void  RegionEnter ();
+
+  void  RegionExit ();
+
+  void* RegionAlloc (gsize size);
+
+  bool  RegionContains (void *pointer);
+
+  void  RegionTrack (Local<Object> wrapper, void *pointer);
+
+};
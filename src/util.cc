@@ -5,6 +5,8 @@
  * Distributed under terms of the MIT license.
  */
 
+#include <string.h>
+
 #include <node.h>
 #include <nan.h>
 #include <girepository.h>
@@ -45,4 +47,31 @@ char* GetSignalName(const char* signal_detail) {
     return signal_name;
 }
 
+/*
+ * Converts a lowerCamelCase name (as exposed to JS) to its GObject form,
+ * eg. "useUnderline" to "use-underline"
+ */
+char* ToDashedName (const char* name) {
+    GString *result = g_string_sized_new (strlen (name) + 4);
+
+    for (const char *c = name; *c != '\0'; c++) {
+        if (g_ascii_isupper (*c)) {
+            g_string_append_c (result, '-');
+            g_string_append_c (result, g_ascii_tolower (*c));
+        } else {
+            g_string_append_c (result, *c);
+        }
+    }
+
+    return g_string_free (result, FALSE);
+}
+
+void* GetArrayBufferData (Local<v8::ArrayBuffer> buffer) {
+#if V8_MAJOR_VERSION >= 8
+    return buffer->GetBackingStore()->Data();
+#else
+    return buffer->GetContents().Data();
+#endif
+}
+
 }
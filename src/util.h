@@ -8,6 +8,7 @@
 #pragma once
 
 #include <node.h>
+#include <v8.h>
 #include <girepository.h>
 
 namespace Util
@@ -17,4 +18,8 @@ namespace Util
 
     char*          GetSignalName(const char* signal_detail);
 
+    char*          ToDashedName (const char* name);
+
+    void*          GetArrayBufferData (v8::Local<v8::ArrayBuffer> buffer);
+
 } /* Util */
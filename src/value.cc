@@ -2,6 +2,7 @@
 //#include <node.h>
 //#include <nan.h>
 #include <glib.h>
+#include <math.h>
 
 #include "boxed.h"
 #include "function.h"
@@ -17,8 +18,10 @@
 
 using v8::Array;
 using v8::Boolean;
+using v8::Function;
 using v8::Integer;
 using v8::Local;
+using v8::MaybeLocal;
 using v8::Number;
 using v8::Object;
 using v8::String;
@@ -33,8 +36,25 @@ static void HashPointerToGIArgument (GIArgument *arg, GITypeInfo *type_info);
 
 static bool IsUint8Array (GITypeInfo *type_info);
 
+/*
+ * The wrapper takes its own reference: drop the one transferred to us, unless
+ * it was floating, in which case it was sunk into the wrapper's.
+ */
+static Local<Value> WrapperFromTransferredGObject (GObject *gobject, GITransfer transfer) {
+    bool owned = gobject != NULL
+        && transfer == GI_TRANSFER_EVERYTHING
+        && !g_object_is_floating (gobject);
 
-Local<Value> GIArgumentToV8(GITypeInfo *type_info, GIArgument *arg, long length) {
+    Local<Value> value = WrapperFromGObject (gobject);
+
+    if (owned)
+        g_object_unref (gobject);
+
+    return value;
+}
+
+
+Local<Value> GIArgumentToV8(GITypeInfo *type_info, GIArgument *arg, long length, GITransfer transfer, Local<Object> owner) {
     GITypeTag type_tag = g_type_info_get_tag (type_info);
 
     switch (type_tag) {
@@ -59,15 +79,15 @@ Local<Value> GIArgumentToV8(GITypeInfo *type_info, GIArgument *arg, long length)
     case GI_TYPE_TAG_DOUBLE:
         return New<Number> (arg->v_double);
 
-    /* For 64-bit integer types, use a float. When JS and V8 adopt
-     * bigger sized integer types, start using those instead. */
+    /* For 64-bit integer types, use a float unless BigInt mode is
+     * enabled for this namespace. See SetBigIntMode. */
     case GI_TYPE_TAG_INT64:
-        return New<Number> (arg->v_int64);
+        return Int64ToV8 (arg->v_int64, UseBigInt (type_info));
     case GI_TYPE_TAG_UINT64:
-        return New<Number> (arg->v_uint64);
+        return Uint64ToV8 (arg->v_uint64, UseBigInt (type_info));
 
-    case GI_TYPE_TAG_GTYPE: /* c++: gulong */
-        return New<Number>((double)arg->v_ulong);
+    case GI_TYPE_TAG_GTYPE: /* c++: gsize */
+        return Uint64ToV8 (arg->v_size, UseBigInt (type_info));
 
     case GI_TYPE_TAG_UNICHAR:
         {
@@ -120,20 +140,25 @@ Local<Value> GIArgumentToV8(GITypeInfo *type_info, GIArgument *arg, long length)
                 if (G_IS_PARAM_SPEC(arg->v_pointer))
                     value = ParamSpec::FromGParamSpec((GParamSpec *)arg->v_pointer);
                 else
-                    value = WrapperFromGObject((GObject *)arg->v_pointer, interface_info);
+                    value = WrapperFromTransferredGObject((GObject *)arg->v_pointer, transfer);
                 break;
             case GI_INFO_TYPE_BOXED:
             case GI_INFO_TYPE_STRUCT:
             case GI_INFO_TYPE_UNION:
-                value = WrapperFromBoxed (interface_info, arg->v_pointer);
+                value = WrapperFromBoxed (interface_info, arg->v_pointer, transfer, owner);
                 break;
             case GI_INFO_TYPE_ENUM:
             case GI_INFO_TYPE_FLAGS:
                 value = New<Number>(arg->v_long);
                 break;
             case GI_INFO_TYPE_INTERFACE:
-                g_warning ("GIArgumentToV8: Unsuported conversion: from interface. Using null placeholder");
-                value = Nan::Null();
+                /* Wrapped with the class of the implementing object */
+                if (arg->v_pointer == NULL || G_IS_OBJECT (arg->v_pointer)) {
+                    value = WrapperFromTransferredGObject((GObject *)arg->v_pointer, transfer);
+                } else {
+                    g_warning ("GIArgumentToV8: Unsuported conversion: from non-GObject interface. Using null placeholder");
+                    value = Nan::Null();
+                }
                 break;
             default:
                 print_info (interface_info);
@@ -145,16 +170,16 @@ Local<Value> GIArgumentToV8(GITypeInfo *type_info, GIArgument *arg, long length)
         }
 
     case GI_TYPE_TAG_ARRAY:
-        return ArrayToV8(type_info, arg->v_pointer, length);
+        return ArrayToV8(type_info, arg->v_pointer, length, transfer, owner);
 
     case GI_TYPE_TAG_GLIST:
-        return GListToV8(type_info, (GList *)arg->v_pointer);
+        return GListToV8(type_info, (GList *)arg->v_pointer, transfer, owner);
 
     case GI_TYPE_TAG_GSLIST:
-        return GSListToV8(type_info, (GSList *)arg->v_pointer);
+        return GSListToV8(type_info, (GSList *)arg->v_pointer, transfer, owner);
 
     case GI_TYPE_TAG_GHASH:
-        return GHashToV8(type_info, (GHashTable *)arg->v_pointer);
+        return GHashToV8(type_info, (GHashTable *)arg->v_pointer, transfer, owner);
 
     default:
         g_critical("Tag: %s", g_type_tag_to_string(type_tag));
@@ -162,7 +187,12 @@ Local<Value> GIArgumentToV8(GITypeInfo *type_info, GIArgument *arg, long length)
     }
 }
 
-Local<Value> GListToV8 (GITypeInfo *type_info, GList *glist) {
+/* Elements of a container are only owned with the container if transfer is full */
+static inline GITransfer ElementTransfer (GITransfer transfer) {
+    return transfer == GI_TRANSFER_EVERYTHING ? GI_TRANSFER_EVERYTHING : GI_TRANSFER_NOTHING;
+}
+
+Local<Value> GListToV8 (GITypeInfo *type_info, GList *glist, GITransfer transfer, Local<Object> owner) {
     GITypeInfo *param_info = g_type_info_get_param_type(type_info, 0);
 
     g_assert(param_info != NULL);
@@ -173,7 +203,7 @@ Local<Value> GListToV8 (GITypeInfo *type_info, GList *glist) {
     int i = 0;
     for (; glist != NULL; glist = glist->next) {
         arg.v_pointer = glist->data;
-        Nan::Set(array, i, GIArgumentToV8(param_info, &arg));
+        Nan::Set(array, i, GIArgumentToV8(param_info, &arg, -1, ElementTransfer (transfer), owner));
         i++;
     }
 
@@ -181,7 +211,7 @@ Local<Value> GListToV8 (GITypeInfo *type_info, GList *glist) {
     return array;
 }
 
-Local<Value> GSListToV8 (GITypeInfo *type_info, GSList *list) {
+Local<Value> GSListToV8 (GITypeInfo *type_info, GSList *list, GITransfer transfer, Local<Object> owner) {
     GITypeInfo *param_info = g_type_info_get_param_type(type_info, 0);
     g_assert(param_info != NULL);
 
@@ -191,7 +221,7 @@ Local<Value> GSListToV8 (GITypeInfo *type_info, GSList *list) {
     int i = 0;
     for (; list != NULL; list = list->next) {
         arg.v_pointer = list->data;
-        Nan::Set(array, i, GIArgumentToV8(param_info, &arg));
+        Nan::Set(array, i, GIArgumentToV8(param_info, &arg, -1, ElementTransfer (transfer), owner));
         i++;
     }
 
@@ -199,7 +229,7 @@ Local<Value> GSListToV8 (GITypeInfo *type_info, GSList *list) {
     return array;
 }
 
-Local<Value> GHashToV8 (GITypeInfo *type_info, GHashTable *hash_table) {
+Local<Value> GHashToV8 (GITypeInfo *type_info, GHashTable *hash_table, GITransfer transfer, Local<Object> owner) {
     GITypeInfo *key_info   = g_type_info_get_param_type (type_info, 0);
     GITypeInfo *value_info = g_type_info_get_param_type (type_info, 1);
 
@@ -214,7 +244,7 @@ Local<Value> GHashToV8 (GITypeInfo *type_info, GHashTable *hash_table) {
         HashPointerToGIArgument(&value_arg, value_info);
 
         auto key   = GIArgumentToV8(key_info, &key_arg);
-        auto value = GIArgumentToV8(value_info, &value_arg);
+        auto value = GIArgumentToV8(value_info, &value_arg, -1, ElementTransfer (transfer), owner);
 
         Nan::Set(object, key, value);
     }
@@ -225,7 +255,165 @@ Local<Value> GHashToV8 (GITypeInfo *type_info, GHashTable *hash_table) {
     return object;
 }
 
-Local<Value> ArrayToV8 (GITypeInfo *type_info, void* data, long length) {
+/*
+ * Struct array views: arrays of inline structs are exposed as one
+ * ArrayBuffer plus per-field strided accessors (see lib/struct_array.js),
+ * instead of one boxed wrapper per element.
+ */
+
+static Nan::Persistent<Function> structArrayViewClass;
+
+void RegisterStructArrayView (Local<Function> view_class) {
+    structArrayViewClass.Reset (view_class);
+}
+
+/**
+ * @returns the struct/union info if the type is an inline (non-pointer)
+ *     struct or union, NULL otherwise
+ */
+static GIBaseInfo *GetInlineStructInfo (GITypeInfo *type_info) {
+    if (g_type_info_get_tag (type_info) != GI_TYPE_TAG_INTERFACE || g_type_info_is_pointer (type_info))
+        return NULL;
+
+    GIBaseInfo *interface_info = g_type_info_get_interface (type_info);
+    GIInfoType interface_type = g_base_info_get_type (interface_info);
+
+    if (interface_type == GI_INFO_TYPE_STRUCT || interface_type == GI_INFO_TYPE_UNION)
+        return interface_info;
+
+    g_base_info_unref (interface_info);
+    return NULL;
+}
+
+bool IsStructArrayView (Local<Value> value) {
+    if (structArrayViewClass.IsEmpty () || !value->IsObject ())
+        return false;
+
+    auto view_class = Nan::New<Function> (structArrayViewClass);
+    return Nan::To<Object> (value).ToLocalChecked ()
+        ->InstanceOf (Nan::GetCurrentContext (), view_class).FromMaybe (false);
+}
+
+static Local<Array> GetStructLayout (GIBaseInfo *struct_info) {
+    bool is_union = g_base_info_get_type (struct_info) == GI_INFO_TYPE_UNION;
+    int n_fields = is_union ?
+        g_union_info_get_n_fields ((GIUnionInfo *) struct_info) :
+        g_struct_info_get_n_fields ((GIStructInfo *) struct_info);
+
+    Local<Array> layout = New<Array> ();
+    uint32_t n_scalars = 0;
+
+    for (int i = 0; i < n_fields; i++) {
+        GIFieldInfo *field = is_union ?
+            g_union_info_get_field ((GIUnionInfo *) struct_info, i) :
+            g_struct_info_get_field ((GIStructInfo *) struct_info, i);
+        GITypeTag tag;
+
+        if (GetFieldStorageTag (field, &tag)) {
+            Local<Array> entry = New<Array> (3);
+            Nan::Set (entry, 0, UTF8 (g_base_info_get_name (field)));
+            Nan::Set (entry, 1, New<v8::Uint32> (g_field_info_get_offset (field)));
+            Nan::Set (entry, 2, UTF8 (g_type_tag_to_string (tag)));
+            Nan::Set (layout, n_scalars++, entry);
+        }
+
+        g_base_info_unref (field);
+    }
+
+    return layout;
+}
+
+static Local<Value> StructArrayToV8 (GIBaseInfo *struct_info, void *data, long length, gsize element_size) {
+    if (structArrayViewClass.IsEmpty ()) {
+        Nan::ThrowError ("Struct array views are not available");
+        return Nan::Null ();
+    }
+
+    Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New (v8::Isolate::GetCurrent (), length * element_size);
+    memcpy (Util::GetArrayBufferData (buffer), data, length * element_size);
+
+    Local<Value> args[] = {
+        MakeBoxedClass (struct_info),
+        buffer,
+        New<Number> (length),
+        New<Number> (element_size),
+        GetStructLayout (struct_info),
+    };
+
+    auto view_class = Nan::New<Function> (structArrayViewClass);
+    auto view = Nan::NewInstance (view_class, G_N_ELEMENTS (args), args);
+
+    if (view.IsEmpty ())
+        return Nan::Null ();
+    return view.ToLocalChecked ();
+}
+
+/**
+ * Copies a struct array view, or an array of boxed wrappers, to an array
+ * of inline structs
+ * @returns false if an exception has been thrown
+ */
+static bool V8ToStructArray (GIBaseInfo *struct_info, Local<Value> value, void *result, long length, gsize element_size) {
+    GType gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) struct_info);
+
+    if (IsStructArrayView (value)) {
+        auto view         = TO_OBJECT (value);
+        auto struct_class = Nan::Get (view, UTF8 ("structClass")).ToLocalChecked ();
+        auto buffer       = Nan::Get (view, UTF8 ("buffer")).ToLocalChecked ();
+        auto stride       = Nan::To<uint32_t> (Nan::Get (view, UTF8 ("stride")).ToLocalChecked ()).ToChecked ();
+
+        if (!struct_class->StrictEquals (MakeBoxedClass (struct_info))) {
+            char *message = g_strdup_printf ("Struct array view is not an array of %s.%s",
+                    g_base_info_get_namespace (struct_info), g_base_info_get_name (struct_info));
+            Nan::ThrowTypeError (message);
+            g_free (message);
+            return false;
+        }
+
+        if (stride != element_size) {
+            Nan::ThrowTypeError ("Struct array view has the wrong element size");
+            return false;
+        }
+
+        if (!buffer->IsArrayBuffer ()
+                || buffer.As<v8::ArrayBuffer> ()->ByteLength () < (size_t) length * element_size) {
+            Nan::ThrowTypeError ("Struct array view is smaller than its length");
+            return false;
+        }
+
+        memcpy (result, Util::GetArrayBufferData (buffer.As<v8::ArrayBuffer> ()), length * element_size);
+        return true;
+    }
+
+    auto array = TO_OBJECT (value);
+
+    for (long i = 0; i < length; i++) {
+        auto element = Nan::Get (array, i).ToLocalChecked ();
+        void *pointer = (void *)((ulong) result + i * element_size);
+
+        bool is_instance = gtype != G_TYPE_NONE ?
+            ValueIsInstanceOfGType (element, gtype) :
+            ValueHasInternalField (element);
+
+        if (!is_instance || BoxedFromWrapper (element) == NULL) {
+            char *message = g_strdup_printf ("Array element %li is not a %s.%s",
+                    i, g_base_info_get_namespace (struct_info), g_base_info_get_name (struct_info));
+            Nan::ThrowTypeError (message);
+            g_free (message);
+            return false;
+        }
+
+        memcpy (pointer, BoxedFromWrapper (element), element_size);
+    }
+
+    return true;
+}
+
+long GetArrayLikeLength (Local<Value> value) {
+    return Nan::To<uint32_t> (Nan::Get (TO_OBJECT (value), UTF8 ("length")).ToLocalChecked ()).ToChecked ();
+}
+
+Local<Value> ArrayToV8 (GITypeInfo *type_info, void* data, long length, GITransfer transfer, Local<Object> owner) {
 
     auto array = New<Array>();
 
@@ -280,6 +468,20 @@ Local<Value> ArrayToV8 (GITypeInfo *type_info, void* data, long length) {
         goto out;
 
 
+    /*
+     * Inline structs & unions: a struct array view over a copy of the buffer
+     */
+
+    {
+        GIBaseInfo *struct_info = GetInlineStructInfo (elem_type_info);
+        if (struct_info != NULL) {
+            Local<Value> view = StructArrayToV8 (struct_info, data, length, element_size);
+            g_base_info_unref (struct_info);
+            g_base_info_unref (elem_type_info);
+            return view;
+        }
+    }
+
     /*
      * Fill array elements
      */
@@ -289,7 +491,7 @@ Local<Value> ArrayToV8 (GITypeInfo *type_info, void* data, long length) {
     for (int i = 0; i < length; i++) {
         void** pointer = (void**)((ulong)data + i * element_size);
         memcpy(&value, pointer, element_size);
-        Nan::Set(array, i, GIArgumentToV8(elem_type_info, &value));
+        Nan::Set(array, i, GIArgumentToV8(elem_type_info, &value, -1, ElementTransfer (transfer), owner));
     }
 
 
@@ -353,7 +555,29 @@ void * V8ToCArray(GITypeInfo *type_info, Local<Value> value) {
         return g_strdup(utf8_data);
     }
 
+    GITypeInfo* element_info = g_type_info_get_param_type (type_info, 0);
+    gsize element_size = GetTypeSize(element_info);
+    GIBaseInfo* struct_info = GetInlineStructInfo (element_info);
+
+    if (struct_info != NULL && (value->IsArray() || IsStructArrayView(value))) {
+        long length = GetArrayLikeLength (value);
+        void *result = g_malloc0(element_size * (length + (is_zero_terminated ? 1 : 0)));
+
+        if (!V8ToStructArray (struct_info, value, result, length, element_size)) {
+            g_free (result);
+            result = NULL;
+        }
+
+        g_base_info_unref (struct_info);
+        g_base_info_unref (element_info);
+        return result;
+    }
+
+    if (struct_info != NULL)
+        g_base_info_unref (struct_info);
+
     if (!value->IsArray()) {
+        g_base_info_unref (element_info);
         Nan::ThrowTypeError("Expected value to be an array");
         return NULL;
     }
@@ -361,9 +585,6 @@ void * V8ToCArray(GITypeInfo *type_info, Local<Value> value) {
     auto array = Local<Array>::Cast (TO_OBJECT (value));
     int length = array->Length();
 
-    GITypeInfo* element_info = g_type_info_get_param_type (type_info, 0);
-    gsize element_size = GetTypeSize(element_info);
-
     void *result = malloc(element_size * (length + (is_zero_terminated ? 1 : 0)));
 
     for (int i = 0; i < length; i++) {
@@ -549,6 +770,10 @@ bool V8ToGIArgument(GIBaseInfo *gi_info, GIArgument *arg, Local<Value> value) {
     case GI_INFO_TYPE_STRUCT:
     case GI_INFO_TYPE_UNION:
         arg->v_pointer = BoxedFromWrapper(value);
+        if (arg->v_pointer == NULL) {
+            Nan::ThrowError("Boxed has been released (used outside of its region?)");
+            return false;
+        }
         break;
 
     case GI_INFO_TYPE_FLAGS:
@@ -568,6 +793,10 @@ bool V8ToGIArgument(GIBaseInfo *gi_info, GIArgument *arg, Local<Value> value) {
     }
     case GI_INFO_TYPE_INTERFACE:
         arg->v_pointer = GObjectFromWrapper(value);
+        if (arg->v_pointer == NULL && ValueIsGObject(value)) {
+            Nan::ThrowError("Object has been disposed");
+            return false;
+        }
         break;
 
     case GI_INFO_TYPE_CALLBACK:
@@ -609,7 +838,10 @@ bool V8ToGIArgument(GITypeInfo *type_info, GIArgument *arg, Local<Value> value,
         arg->v_int = Nan::To<int32_t> (value).ToChecked();
         break;
     case GI_TYPE_TAG_INT64:
-        arg->v_int64 = Nan::To<int64_t> (value).ToChecked();
+        if (!V8ToInt64 (value, &arg->v_int64)) {
+            Nan::ThrowRangeError("Value out of range for a 64-bit integer");
+            return false;
+        }
         break;
     case GI_TYPE_TAG_UINT8:
         arg->v_uint8 = Nan::To<uint32_t> (value).ToChecked();
@@ -621,7 +853,10 @@ bool V8ToGIArgument(GITypeInfo *type_info, GIArgument *arg, Local<Value> value,
         arg->v_uint = Nan::To<uint32_t> (value).ToChecked();
         break;
     case GI_TYPE_TAG_UINT64:
-        arg->v_uint64 = Nan::To<int64_t> (value).ToChecked();
+        if (!V8ToUint64 (value, &arg->v_uint64)) {
+            Nan::ThrowRangeError("Value out of range for an unsigned 64-bit integer");
+            return false;
+        }
         break;
     case GI_TYPE_TAG_FLOAT:
         arg->v_float = Nan::To<double> (value).ToChecked();
@@ -630,7 +865,14 @@ bool V8ToGIArgument(GITypeInfo *type_info, GIArgument *arg, Local<Value> value,
         arg->v_double = Nan::To<double> (value).ToChecked();
         break;
     case GI_TYPE_TAG_GTYPE:
-        arg->v_ulong = Nan::To<int64_t> (value).ToChecked();
+        {
+            guint64 gtype;
+            if (!V8ToUint64 (value, &gtype)) {
+                Nan::ThrowRangeError("Value out of range for a GType");
+                return false;
+            }
+            arg->v_size = (gsize) gtype;
+        }
         break;
 
     case GI_TYPE_TAG_UTF8:
@@ -670,8 +912,10 @@ bool V8ToGIArgument(GITypeInfo *type_info, GIArgument *arg, Local<Value> value,
     case GI_TYPE_TAG_INTERFACE:
         {
             GIBaseInfo *interface_info = g_type_info_get_interface (type_info);
-            V8ToGIArgument (interface_info, arg, value);
+            bool success = V8ToGIArgument (interface_info, arg, value);
             g_base_info_unref(interface_info);
+            if (!success)
+                return false;
         }
         break;
 
@@ -724,16 +968,18 @@ bool CanConvertV8ToGIArgument(GITypeInfo *type_info, Local<Value> value, bool ma
     case GI_TYPE_TAG_INT8:
     case GI_TYPE_TAG_INT16:
     case GI_TYPE_TAG_INT32:
-    case GI_TYPE_TAG_INT64:
     case GI_TYPE_TAG_UINT8:
     case GI_TYPE_TAG_UINT16:
     case GI_TYPE_TAG_UINT32:
-    case GI_TYPE_TAG_UINT64:
     case GI_TYPE_TAG_FLOAT:
     case GI_TYPE_TAG_DOUBLE:
-    case GI_TYPE_TAG_GTYPE:
         return value->IsNumber ();
 
+    case GI_TYPE_TAG_INT64:
+    case GI_TYPE_TAG_UINT64:
+    case GI_TYPE_TAG_GTYPE:
+        return value->IsNumber () || value->IsBigInt ();
+
     case GI_TYPE_TAG_UTF8:
         return true;
 
@@ -750,10 +996,13 @@ bool CanConvertV8ToGIArgument(GITypeInfo *type_info, Local<Value> value, bool ma
             switch (type) {
             case GI_INFO_TYPE_OBJECT:
             case GI_INFO_TYPE_INTERFACE:
+                result = ValueIsInstanceOfGType (value, g_registered_type_info_get_g_type (interface_info));
+                break;
             case GI_INFO_TYPE_BOXED:
             case GI_INFO_TYPE_STRUCT:
             case GI_INFO_TYPE_UNION:
-                result = ValueIsInstanceOfGType (value, g_registered_type_info_get_g_type (interface_info));
+                result = ValueIsInstanceOfGType (value, g_registered_type_info_get_g_type (interface_info))
+                    && BoxedFromWrapper (value) != NULL;
                 break;
             case GI_INFO_TYPE_FLAGS:
             case GI_INFO_TYPE_ENUM:
@@ -778,6 +1027,9 @@ bool CanConvertV8ToGIArgument(GITypeInfo *type_info, Local<Value> value, bool ma
             if (value->IsString () && IsUint8Array(type_info))
                 return true;
 
+            if (type_tag == GI_TYPE_TAG_ARRAY && IsStructArrayView (value))
+                return true;
+
             if (!value->IsArray ())
                 return false;
 
@@ -814,6 +1066,44 @@ bool CanConvertV8ToGIArgument(GITypeInfo *type_info, Local<Value> value, bool ma
     return false;
 }
 
+/*
+ * Wrappers keep their own reference: takes the one C expects to receive when
+ * an object is transferred to it (in arguments, callback return values).
+ */
+static GObject* GetTransferredGObject(GITypeInfo *type_info, GIArgument *arg, GITransfer transfer) {
+    if (transfer != GI_TRANSFER_EVERYTHING
+            || g_type_info_get_tag (type_info) != GI_TYPE_TAG_INTERFACE
+            || arg->v_pointer == NULL)
+        return NULL;
+
+    GIBaseInfo *interface_info = g_type_info_get_interface (type_info);
+    GIInfoType interface_type = g_base_info_get_type (interface_info);
+    GObject *gobject = NULL;
+
+    if ((interface_type == GI_INFO_TYPE_OBJECT || interface_type == GI_INFO_TYPE_INTERFACE)
+            && G_IS_OBJECT (arg->v_pointer))
+        gobject = G_OBJECT (arg->v_pointer);
+
+    g_base_info_unref (interface_info);
+    return gobject;
+}
+
+void RefTransferredGObject(GITypeInfo *type_info, GIArgument *arg, GITransfer transfer) {
+    GObject *gobject = GetTransferredGObject (type_info, arg, transfer);
+    if (gobject != NULL)
+        g_object_ref (gobject);
+}
+
+/*
+ * Drops the reference taken by RefTransferredGObject, when the call failed
+ * before C could receive it
+ */
+void UnrefTransferredGObject(GITypeInfo *type_info, GIArgument *arg, GITransfer transfer) {
+    GObject *gobject = GetTransferredGObject (type_info, arg, transfer);
+    if (gobject != NULL)
+        g_object_unref (gobject);
+}
+
 void FreeGIArgument(GITypeInfo *type_info, GIArgument *arg, GITransfer transfer, GIDirection direction) {
     bool is_in  = direction == GI_DIRECTION_IN;
     bool is_out = direction == GI_DIRECTION_OUT || direction == GI_DIRECTION_INOUT;
@@ -1079,134 +1369,503 @@ void FreeGIArgumentArray(GITypeInfo *type_info, GIArgument *arg, GITransfer tran
 }
 
 
-bool V8ToGValue(GValue *gvalue, Local<Value> value) {
-    if (G_VALUE_HOLDS_BOOLEAN (gvalue)) {
-        g_value_set_boolean (gvalue, Nan::To<bool> (value).ToChecked());
-    } else if (G_VALUE_HOLDS_INT (gvalue) || G_VALUE_HOLDS_LONG (gvalue)) {
-        g_value_set_int (gvalue, Nan::To<int32_t> (value).ToChecked());
-    } else if (G_VALUE_HOLDS_UINT (gvalue)) {
-        g_value_set_uint (gvalue, Nan::To<uint32_t> (value).ToChecked());
-    } else if (G_VALUE_HOLDS_FLOAT (gvalue)) {
-        g_value_set_float (gvalue, Nan::To<double> (value).ToChecked());
-    } else if (G_VALUE_HOLDS_DOUBLE (gvalue)) {
-        g_value_set_double (gvalue, Nan::To<double> (value).ToChecked());
-    } else if (G_VALUE_HOLDS_GTYPE (gvalue)) {
-        GType type;
+/*
+ * GValue conversion
+ *
+ * Converters are registered per fundamental GType and looked up by the
+ * fundamental index of the value type, so dispatch is a single array access.
+ * Overrides can additionally register JS converters for specific GTypes
+ * (see RegisterValueConverter in gi.cc), which are applied on top of the
+ * fundamental conversion.
+ */
+
+#define N_FUNDAMENTALS ((G_TYPE_FUNDAMENTAL_MAX >> G_TYPE_FUNDAMENTAL_SHIFT) + 1)
+
+struct JSValueConverter {
+    Nan::Persistent<v8::Function> to_js;
+    Nan::Persistent<v8::Function> from_js;
+};
+
+static const GValueConverter *gvalueConverters[N_FUNDAMENTALS] = {};
+static bool gvalueConvertersInitialized = false;
+static int  nJSValueConverters = 0;
+
+static void InitGValueConverters ();
+
+const GValueConverter *GetGValueConverter (GType gtype) {
+    if (G_UNLIKELY (!gvalueConvertersInitialized))
+        InitGValueConverters ();
+
+    return gvalueConverters[G_TYPE_FUNDAMENTAL (gtype) >> G_TYPE_FUNDAMENTAL_SHIFT];
+}
+
+void RegisterGValueConverter (GType fundamental, const GValueConverter *converter) {
+    g_assert (G_TYPE_IS_FUNDAMENTAL (fundamental));
+
+    if (G_UNLIKELY (!gvalueConvertersInitialized))
+        InitGValueConverters ();
+
+    gvalueConverters[fundamental >> G_TYPE_FUNDAMENTAL_SHIFT] = converter;
+}
+
+void RegisterJSValueConverter (GType gtype, Local<Value> to_js, Local<Value> from_js) {
+    auto *converter = (JSValueConverter *) g_type_get_qdata (gtype, GNodeJS::converter_quark());
+
+    if (converter == NULL) {
+        if (!to_js->IsFunction() && !from_js->IsFunction())
+            return;
+        converter = new JSValueConverter();
+        g_type_set_qdata (gtype, GNodeJS::converter_quark(), converter);
+        nJSValueConverters++;
+    }
+
+    if (to_js->IsFunction())
+        converter->to_js.Reset(to_js.As<v8::Function>());
+    else
+        converter->to_js.Reset();
+
+    if (from_js->IsFunction())
+        converter->from_js.Reset(from_js.As<v8::Function>());
+    else
+        converter->from_js.Reset();
+
+    if (converter->to_js.IsEmpty() && converter->from_js.IsEmpty()) {
+        g_type_set_qdata (gtype, GNodeJS::converter_quark(), NULL);
+        nJSValueConverters--;
+        delete converter;
+    }
+}
+
+static inline JSValueConverter *GetJSValueConverter (GType gtype) {
+    if (G_LIKELY (nJSValueConverters == 0))
+        return NULL;
+    return (JSValueConverter *) g_type_get_qdata (gtype, GNodeJS::converter_quark());
+}
+
+static MaybeLocal<Value> CallJSValueConverter (Nan::Persistent<v8::Function> &fn, Local<Value> value) {
+    Local<v8::Function> function = Nan::New<v8::Function> (fn);
+    Local<Value> args[] = { value };
+    return Nan::Call (function, Nan::GetCurrentContext()->Global(), 1, args);
+}
+
+
+/*
+ * Fundamental converters
+ */
+
+static Local<Value> InvalidToV8 (const GValue *gvalue) {
+    return Nan::Undefined ();
+}
+static bool InvalidFromV8 (GValue *gvalue, Local<Value> value) {
+    return true;
+}
+static bool NumberCanConvert (GValue *gvalue, Local<Value> value) {
+    return !value->IsBigInt ();
+}
+static bool Number64CanConvert (GValue *gvalue, Local<Value> value) {
+    return value->IsNumber () || value->IsBigInt ();
+}
+static bool AlwaysCanConvert (GValue *gvalue, Local<Value> value) {
+    return true;
+}
+static bool InstanceCanConvert (GValue *gvalue, Local<Value> value) {
+    return ValueIsInstanceOfGType (value, G_VALUE_TYPE (gvalue));
+}
+
+static Local<Value> CharToV8 (const GValue *gvalue) {
+    return New<v8::Int32> (g_value_get_schar (gvalue));
+}
+static bool CharFromV8 (GValue *gvalue, Local<Value> value) {
+    g_value_set_schar (gvalue, Nan::To<int32_t> (value).ToChecked());
+    return true;
+}
+
+static Local<Value> UCharToV8 (const GValue *gvalue) {
+    return New<v8::Uint32> (g_value_get_uchar (gvalue));
+}
+static bool UCharFromV8 (GValue *gvalue, Local<Value> value) {
+    g_value_set_uchar (gvalue, Nan::To<uint32_t> (value).ToChecked());
+    return true;
+}
+
+static Local<Value> BooleanToV8 (const GValue *gvalue) {
+    return New<Boolean> (g_value_get_boolean (gvalue) != FALSE);
+}
+static bool BooleanFromV8 (GValue *gvalue, Local<Value> value) {
+    g_value_set_boolean (gvalue, Nan::To<bool> (value).ToChecked());
+    return true;
+}
+
+static Local<Value> IntToV8 (const GValue *gvalue) {
+    return New<Integer> (g_value_get_int (gvalue));
+}
+static bool IntFromV8 (GValue *gvalue, Local<Value> value) {
+    g_value_set_int (gvalue, Nan::To<int32_t> (value).ToChecked());
+    return true;
+}
+
+static Local<Value> UIntToV8 (const GValue *gvalue) {
+    return New<v8::Uint32> (g_value_get_uint (gvalue));
+}
+static bool UIntFromV8 (GValue *gvalue, Local<Value> value) {
+    g_value_set_uint (gvalue, Nan::To<uint32_t> (value).ToChecked());
+    return true;
+}
+
+static Local<Value> LongToV8 (const GValue *gvalue) {
+    return Int64ToV8 (g_value_get_long (gvalue), UseBigInt (NULL));
+}
+static bool LongFromV8 (GValue *gvalue, Local<Value> value) {
+    gint64 result;
+    if (!V8ToInt64 (value, &result) || result < G_MINLONG || result > G_MAXLONG) {
+        Nan::ThrowRangeError("Value out of range for a long");
+        return false;
+    }
+    g_value_set_long (gvalue, (glong) result);
+    return true;
+}
+
+static Local<Value> ULongToV8 (const GValue *gvalue) {
+    return Uint64ToV8 (g_value_get_ulong (gvalue), UseBigInt (NULL));
+}
+static bool ULongFromV8 (GValue *gvalue, Local<Value> value) {
+    guint64 result;
+    if (!V8ToUint64 (value, &result) || result > G_MAXULONG) {
+        Nan::ThrowRangeError("Value out of range for an unsigned long");
+        return false;
+    }
+    g_value_set_ulong (gvalue, (gulong) result);
+    return true;
+}
+
+static Local<Value> GInt64ToV8 (const GValue *gvalue) {
+    return Int64ToV8 (g_value_get_int64 (gvalue), UseBigInt (NULL));
+}
+static bool GInt64FromV8 (GValue *gvalue, Local<Value> value) {
+    gint64 result;
+    if (!V8ToInt64 (value, &result)) {
+        Nan::ThrowRangeError("Value out of range for a 64-bit integer");
+        return false;
+    }
+    g_value_set_int64 (gvalue, result);
+    return true;
+}
+
+static Local<Value> GUInt64ToV8 (const GValue *gvalue) {
+    return Uint64ToV8 (g_value_get_uint64 (gvalue), UseBigInt (NULL));
+}
+static bool GUInt64FromV8 (GValue *gvalue, Local<Value> value) {
+    guint64 result;
+    if (!V8ToUint64 (value, &result)) {
+        Nan::ThrowRangeError("Value out of range for an unsigned 64-bit integer");
+        return false;
+    }
+    g_value_set_uint64 (gvalue, result);
+    return true;
+}
+
+static Local<Value> EnumToV8 (const GValue *gvalue) {
+    return New<Integer> (g_value_get_enum (gvalue));
+}
+static bool EnumFromV8 (GValue *gvalue, Local<Value> value) {
+    g_value_set_enum (gvalue, Nan::To<int32_t> (value).ToChecked());
+    return true;
+}
+
+static Local<Value> FlagsToV8 (const GValue *gvalue) {
+    return New<v8::Uint32> (g_value_get_flags (gvalue));
+}
+static bool FlagsFromV8 (GValue *gvalue, Local<Value> value) {
+    g_value_set_flags (gvalue, Nan::To<uint32_t> (value).ToChecked());
+    return true;
+}
+
+static Local<Value> FloatToV8 (const GValue *gvalue) {
+    return New<Number> (g_value_get_float (gvalue));
+}
+static bool FloatFromV8 (GValue *gvalue, Local<Value> value) {
+    g_value_set_float (gvalue, Nan::To<double> (value).ToChecked());
+    return true;
+}
+
+static Local<Value> DoubleToV8 (const GValue *gvalue) {
+    return New<Number> (g_value_get_double (gvalue));
+}
+static bool DoubleFromV8 (GValue *gvalue, Local<Value> value) {
+    g_value_set_double (gvalue, Nan::To<double> (value).ToChecked());
+    return true;
+}
+
+static Local<Value> StringToV8 (const GValue *gvalue) {
+    auto str = g_value_get_string (gvalue);
+    if (str)
+        return New<String>(str).ToLocalChecked();
+    else
+        return Nan::EmptyString();
+}
+static bool StringFromV8 (GValue *gvalue, Local<Value> value) {
+    Nan::Utf8String str (value);
+    g_value_set_string (gvalue, *str);
+    return true;
+}
+
+/* GType values are stored as pointers */
+static Local<Value> PointerToV8 (const GValue *gvalue) {
+    if (G_VALUE_HOLDS_GTYPE (gvalue))
+        return Uint64ToV8 (g_value_get_gtype (gvalue), UseBigInt (NULL));
+
+    gpointer pointer = g_value_get_pointer (gvalue);
+    if (pointer == NULL)
+        return Nan::Null();
+    return New<v8::External> (pointer);
+}
+static bool PointerFromV8 (GValue *gvalue, Local<Value> value) {
+    if (G_VALUE_HOLDS_GTYPE (gvalue)) {
+        guint64 type;
         if (value->IsString())
             type = g_type_from_name(*Nan::Utf8String(value));
-        else
-            type = Nan::To<int64_t> (value).ToChecked();
-        g_value_set_gtype(gvalue, type);
-    } else if (G_VALUE_HOLDS_STRING (gvalue)) {
-        Nan::Utf8String str (value);
-        const char *data = *str;
-        g_value_set_string (gvalue, data);
-    } else if (G_VALUE_HOLDS_ENUM (gvalue)) {
-        g_value_set_enum (gvalue, Nan::To<int32_t> (value).ToChecked());
-    } else if (G_VALUE_HOLDS_OBJECT (gvalue)) {
-        if (!ValueIsInstanceOfGType(value, G_VALUE_TYPE (gvalue))) {
-            Nan::ThrowTypeError("Value is not instance of GObject");
-            return false;
-        }
-        g_value_set_object (gvalue, GObjectFromWrapper (value));
-    } else if (G_VALUE_HOLDS_BOXED (gvalue)) {
-        if (!ValueIsInstanceOfGType(value, G_VALUE_TYPE (gvalue))) {
-            Nan::ThrowTypeError("Value is not instance of boxed");
+        else if (!V8ToUint64 (value, &type)) {
+            Nan::ThrowRangeError("Value out of range for a GType");
             return false;
         }
-        g_value_set_boxed (gvalue, BoxedFromWrapper(value));
-    } else if (G_VALUE_HOLDS_PARAM (gvalue)) {
-        if (!ValueIsInstanceOfGType(value, G_VALUE_TYPE (gvalue))) {
-            Nan::ThrowTypeError("Value is not instance of GParamSpec");
-            return false;
-        }
-        g_value_set_param (gvalue, ParamSpec::FromWrapper(value));
-    } else if (G_VALUE_HOLDS_FLAGS (gvalue)) {
-        printf("G_VALUE_HOLDS_FLAGS");
-        g_assert_not_reached ();
-    } else if (G_VALUE_HOLDS_POINTER (gvalue)) {
-        printf("G_VALUE_HOLDS_POINTER");
-        g_assert_not_reached ();
-    } else if (G_VALUE_HOLDS_VARIANT (gvalue)) {
-        printf("G_VALUE_HOLDS_VARIANT");
-        g_assert_not_reached ();
-    } else {
-        g_assert_not_reached ();
+        g_value_set_gtype (gvalue, (GType) type);
+        return true;
     }
-    return true;
-}
 
-bool CanConvertV8ToGValue(GValue *gvalue, Local<Value> value) {
-    if (G_VALUE_HOLDS_BOOLEAN (gvalue)) {
-        return true;
-    } else if (G_VALUE_HOLDS_INT (gvalue) || G_VALUE_HOLDS_LONG (gvalue)) {
-        return true;
-    } else if (G_VALUE_HOLDS_UINT (gvalue)) {
-        return true;
-    } else if (G_VALUE_HOLDS_FLOAT (gvalue)) {
-        return true;
-    } else if (G_VALUE_HOLDS_DOUBLE (gvalue)) {
-        return true;
-    } else if (G_VALUE_HOLDS_GTYPE (gvalue)) {
-        return true;
-    } else if (G_VALUE_HOLDS_STRING (gvalue)) {
+    if (value->IsNullOrUndefined()) {
+        g_value_set_pointer (gvalue, NULL);
         return true;
-    } else if (G_VALUE_HOLDS_ENUM (gvalue)) {
+    }
+    if (value->IsExternal()) {
+        g_value_set_pointer (gvalue, value.As<v8::External>()->Value());
         return true;
-    } else if (G_VALUE_HOLDS_OBJECT (gvalue)) {
-        if (!ValueIsInstanceOfGType(value, G_VALUE_TYPE (gvalue))) {
-            return false;
-        }
-    } else if (G_VALUE_HOLDS_BOXED (gvalue)) {
-        if (!ValueIsInstanceOfGType(value, G_VALUE_TYPE (gvalue))) {
+    }
+
+    Nan::ThrowTypeError("Value is not a pointer");
+    return false;
+}
+static bool PointerCanConvert (GValue *gvalue, Local<Value> value) {
+    if (G_VALUE_HOLDS_GTYPE (gvalue))
+        return value->IsString() || value->IsNumber() || value->IsBigInt();
+    return value->IsNullOrUndefined() || value->IsExternal();
+}
+
+static Local<Value> BoxedToV8 (const GValue *gvalue) {
+    GType type = G_VALUE_TYPE (gvalue);
+
+    if (type == G_TYPE_STRV) {
+        auto strv = (const char **) g_value_get_boxed (gvalue);
+        auto array = New<Array> ();
+        for (int i = 0; strv != NULL && strv[i] != NULL; i++)
+            Nan::Set(array, i, UTF8(strv[i]));
+        return array;
+    }
+
+    g_type_ensure(type);
+    GIBaseInfo *info = g_irepository_find_by_gtype(NULL, type);
+
+    if (info == NULL) {
+        warn("GValueToV8: no introspection data for boxed type %s", g_type_name (type));
+        return Nan::Null();
+    }
+
+    /* The GValue keeps ownership: copy it */
+    Local<Value> obj = WrapperFromBoxed(info, g_value_get_boxed(gvalue), GI_TRANSFER_NOTHING, Local<Object>());
+    g_base_info_unref(info);
+    return obj;
+}
+static bool BoxedFromV8 (GValue *gvalue, Local<Value> value) {
+    if (G_VALUE_HOLDS (gvalue, G_TYPE_STRV)) {
+        if (!value->IsArray()) {
+            Nan::ThrowTypeError("Value is not an array of strings");
             return false;
         }
-    } else if (G_VALUE_HOLDS_FLAGS (gvalue)) {
+        auto array = Local<Array>::Cast (TO_OBJECT (value));
+        int length = array->Length();
+        char **strv = g_new0 (char *, length + 1);
+        for (int i = 0; i < length; i++)
+            strv[i] = g_strdup (*Nan::Utf8String (Nan::Get (array, i).ToLocalChecked()));
+        g_value_take_boxed (gvalue, strv);
+        return true;
+    }
+
+    if (!ValueIsInstanceOfGType(value, G_VALUE_TYPE (gvalue))) {
+        Nan::ThrowTypeError("Value is not instance of boxed");
         return false;
-    } else if (G_VALUE_HOLDS_POINTER (gvalue)) {
+    }
+    g_value_set_boxed (gvalue, BoxedFromWrapper(value));
+    return true;
+}
+static bool BoxedCanConvert (GValue *gvalue, Local<Value> value) {
+    if (G_VALUE_HOLDS (gvalue, G_TYPE_STRV))
+        return value->IsArray();
+    return ValueIsInstanceOfGType (value, G_VALUE_TYPE (gvalue));
+}
+
+static Local<Value> ParamToV8 (const GValue *gvalue) {
+    return ParamSpec::FromGParamSpec (g_value_get_param (gvalue));
+}
+static bool ParamFromV8 (GValue *gvalue, Local<Value> value) {
+    if (!ValueIsInstanceOfGType(value, G_VALUE_TYPE (gvalue))) {
+        Nan::ThrowTypeError("Value is not instance of GParamSpec");
         return false;
-    } else if (G_VALUE_HOLDS_VARIANT (gvalue)) {
+    }
+    g_value_set_param (gvalue, ParamSpec::FromWrapper(value));
+    return true;
+}
+
+static Local<Value> ObjectToV8 (const GValue *gvalue) {
+    return WrapperFromGObject (G_OBJECT (g_value_get_object (gvalue)));
+}
+static bool ObjectFromV8 (GValue *gvalue, Local<Value> value) {
+    if (value->IsNullOrUndefined()) {
+        g_value_set_object (gvalue, NULL);
+        return true;
+    }
+    if (!ValueIsInstanceOfGType(value, G_VALUE_TYPE (gvalue))) {
+        Nan::ThrowTypeError("Value is not instance of GObject");
         return false;
-    } else {
+    }
+    g_value_set_object (gvalue, GObjectFromWrapper (value));
+    return true;
+}
+static bool ObjectCanConvert (GValue *gvalue, Local<Value> value) {
+    return value->IsNullOrUndefined() || ValueIsInstanceOfGType (value, G_VALUE_TYPE (gvalue));
+}
+
+static Local<Value> VariantToV8 (const GValue *gvalue) {
+    /* The wrapper takes its own reference */
+    GVariant *variant = g_value_get_variant (gvalue);
+    if (variant == NULL)
+        return Nan::Null();
+
+    GIBaseInfo *info = g_irepository_find_by_gtype(NULL, G_TYPE_VARIANT);
+    Local<Value> obj = WrapperFromBoxed(info, g_variant_ref_sink (variant));
+    g_base_info_unref(info);
+    return obj;
+}
+static bool VariantFromV8 (GValue *gvalue, Local<Value> value) {
+    if (value->IsNullOrUndefined()) {
+        g_value_set_variant (gvalue, NULL);
+        return true;
+    }
+    if (!ValueIsInstanceOfGType(value, G_TYPE_VARIANT)) {
+        Nan::ThrowTypeError("Value is not instance of GVariant");
         return false;
     }
+    g_value_set_variant (gvalue, (GVariant *) BoxedFromWrapper(value));
     return true;
 }
+static bool VariantCanConvert (GValue *gvalue, Local<Value> value) {
+    return value->IsNullOrUndefined() || ValueIsInstanceOfGType (value, G_TYPE_VARIANT);
+}
+
+static const GValueConverter invalidConverter = { InvalidToV8,  InvalidFromV8,  AlwaysCanConvert };
+static const GValueConverter charConverter    = { CharToV8,     CharFromV8,     NumberCanConvert };
+static const GValueConverter ucharConverter   = { UCharToV8,    UCharFromV8,    NumberCanConvert };
+static const GValueConverter booleanConverter = { BooleanToV8,  BooleanFromV8,  AlwaysCanConvert };
+static const GValueConverter intConverter     = { IntToV8,      IntFromV8,      NumberCanConvert };
+static const GValueConverter uintConverter    = { UIntToV8,     UIntFromV8,     NumberCanConvert };
+static const GValueConverter longConverter    = { LongToV8,     LongFromV8,     Number64CanConvert };
+static const GValueConverter ulongConverter   = { ULongToV8,    ULongFromV8,    Number64CanConvert };
+static const GValueConverter int64Converter   = { GInt64ToV8,   GInt64FromV8,   Number64CanConvert };
+static const GValueConverter uint64Converter  = { GUInt64ToV8,  GUInt64FromV8,  Number64CanConvert };
+static const GValueConverter enumConverter    = { EnumToV8,     EnumFromV8,     NumberCanConvert };
+static const GValueConverter flagsConverter   = { FlagsToV8,    FlagsFromV8,    NumberCanConvert };
+static const GValueConverter floatConverter   = { FloatToV8,    FloatFromV8,    NumberCanConvert };
+static const GValueConverter doubleConverter  = { DoubleToV8,   DoubleFromV8,   NumberCanConvert };
+static const GValueConverter stringConverter  = { StringToV8,   StringFromV8,   AlwaysCanConvert };
+static const GValueConverter pointerConverter = { PointerToV8,  PointerFromV8,  PointerCanConvert };
+static const GValueConverter boxedConverter   = { BoxedToV8,    BoxedFromV8,    BoxedCanConvert };
+static const GValueConverter paramConverter   = { ParamToV8,    ParamFromV8,    InstanceCanConvert };
+static const GValueConverter objectConverter  = { ObjectToV8,   ObjectFromV8,   ObjectCanConvert };
+static const GValueConverter variantConverter = { VariantToV8,  VariantFromV8,  VariantCanConvert };
+
+static void InitGValueConverters () {
+    gvalueConvertersInitialized = true;
+
+#define REGISTER(fundamental, converter) \
+    gvalueConverters[(fundamental) >> G_TYPE_FUNDAMENTAL_SHIFT] = &(converter)
+
+    REGISTER (G_TYPE_INVALID,   invalidConverter);
+    REGISTER (G_TYPE_NONE,      invalidConverter);
+    REGISTER (G_TYPE_INTERFACE, objectConverter);
+    REGISTER (G_TYPE_CHAR,      charConverter);
+    REGISTER (G_TYPE_UCHAR,     ucharConverter);
+    REGISTER (G_TYPE_BOOLEAN,   booleanConverter);
+    REGISTER (G_TYPE_INT,       intConverter);
+    REGISTER (G_TYPE_UINT,      uintConverter);
+    REGISTER (G_TYPE_LONG,      longConverter);
+    REGISTER (G_TYPE_ULONG,     ulongConverter);
+    REGISTER (G_TYPE_INT64,     int64Converter);
+    REGISTER (G_TYPE_UINT64,    uint64Converter);
+    REGISTER (G_TYPE_ENUM,      enumConverter);
+    REGISTER (G_TYPE_FLAGS,     flagsConverter);
+    REGISTER (G_TYPE_FLOAT,     floatConverter);
+    REGISTER (G_TYPE_DOUBLE,    doubleConverter);
+    REGISTER (G_TYPE_STRING,    stringConverter);
+    REGISTER (G_TYPE_POINTER,   pointerConverter);
+    REGISTER (G_TYPE_BOXED,     boxedConverter);
+    REGISTER (G_TYPE_PARAM,     paramConverter);
+    REGISTER (G_TYPE_OBJECT,    objectConverter);
+    REGISTER (G_TYPE_VARIANT,   variantConverter);
+
+#undef REGISTER
+}
+
+
+bool V8ToGValue(GValue *gvalue, Local<Value> value) {
+    GType gtype = G_VALUE_TYPE (gvalue);
+    const GValueConverter *converter = GetGValueConverter (gtype);
+
+    if (converter == NULL) {
+        char *message = g_strdup_printf ("Unsupported conversion to GValue of type %s", g_type_name (gtype));
+        Nan::ThrowTypeError (message);
+        g_free (message);
+        return false;
+    }
+
+    JSValueConverter *js_converter = GetJSValueConverter (gtype);
+    if (G_UNLIKELY (js_converter != NULL && !js_converter->from_js.IsEmpty())) {
+        if (!CallJSValueConverter (js_converter->from_js, value).ToLocal (&value))
+            return false;
+    }
+
+    return converter->from_v8 (gvalue, value);
+}
+
+bool CanConvertV8ToGValue(GValue *gvalue, Local<Value> value) {
+    GType gtype = G_VALUE_TYPE (gvalue);
+    const GValueConverter *converter = GetGValueConverter (gtype);
+
+    if (converter == NULL)
+        return false;
+
+    JSValueConverter *js_converter = GetJSValueConverter (gtype);
+    if (G_UNLIKELY (js_converter != NULL && !js_converter->from_js.IsEmpty()))
+        return true;
+
+    return converter->can_convert (gvalue, value);
+}
 
 Local<Value> GValueToV8(const GValue *gvalue) {
-    if (G_VALUE_HOLDS_BOOLEAN (gvalue)) {
-        if (g_value_get_boolean (gvalue))
-            return New<Boolean>(true);
-        else
-            return New<Boolean>(false);
-    } else if (G_VALUE_HOLDS_INT (gvalue)) {
-        return New<Integer>(g_value_get_int (gvalue));
-    } else if (G_VALUE_HOLDS_UINT (gvalue)) {
-        return New<v8::Uint32>(g_value_get_uint (gvalue));
-    } else if (G_VALUE_HOLDS_FLOAT (gvalue)) {
-        return New<Number>(g_value_get_float (gvalue));
-    } else if (G_VALUE_HOLDS_DOUBLE (gvalue)) {
-        return New<Number>(g_value_get_double (gvalue));
-    } else if (G_VALUE_HOLDS_STRING (gvalue)) {
-        auto str = g_value_get_string (gvalue);
-        if (str)
-            return New<String>(str).ToLocalChecked();
-        else
-            return Nan::EmptyString();
-    } else if (G_VALUE_HOLDS_ENUM (gvalue)) {
-        return New<Integer>(g_value_get_enum (gvalue));
-    } else if (G_VALUE_HOLDS_OBJECT (gvalue)) {
-        return WrapperFromGObject (G_OBJECT (g_value_get_object (gvalue)));
-    } else if (G_VALUE_HOLDS_BOXED (gvalue)) {
-        GType type = G_VALUE_TYPE (gvalue);
-        g_type_ensure(type);
-        GIBaseInfo *info = g_irepository_find_by_gtype(NULL, type);
-        Local<Value> obj = WrapperFromBoxed(info, g_value_get_boxed(gvalue));
-        g_base_info_unref(info);
-        return obj;
-    } else {
-        g_assert_not_reached ();
+    GType gtype = G_VALUE_TYPE (gvalue);
+    const GValueConverter *converter = GetGValueConverter (gtype);
+
+    if (converter == NULL) {
+        warn("GValueToV8: unsupported conversion from type %s", g_type_name (gtype));
+        return Nan::Undefined();
+    }
+
+    Local<Value> value = converter->to_v8 (gvalue);
+
+    JSValueConverter *js_converter = GetJSValueConverter (gtype);
+    if (G_UNLIKELY (js_converter != NULL && !js_converter->to_js.IsEmpty())) {
+        if (!CallJSValueConverter (js_converter->to_js, value).ToLocal (&value))
+            return Nan::Undefined();
     }
+
+    return value;
 }
 
 
@@ -1228,11 +1887,132 @@ bool ValueIsInstanceOfGType(Local<Value> value, GType g_type) {
         return false;
 
     Local<Object> object = TO_OBJECT (value);
+
+    if (ValueIsGObject (object)) {
+        GObject *gobject = GObjectFromWrapper (object);
+        return gobject != NULL && g_type_is_a (G_OBJECT_TYPE (gobject), g_type);
+    }
+
     GType object_type = (GType) Nan::To<int64_t> (Nan::Get(object, UTF8("__gtype__")).ToLocalChecked()).ToChecked();
     return g_type_is_a(object_type, g_type);
 }
 
 
+/*
+ * BigInt mode: 64-bit integers and GTypes are converted to JS BigInts
+ * instead of numbers, which lose precision above 2^53. It can be enabled
+ * for all namespaces or only for some of them.
+ */
+
+static bool        bigIntEnabled    = false;
+static GHashTable *bigIntNamespaces = NULL;
+
+void SetBigIntMode (bool enabled, const char *ns) {
+    if (ns == NULL) {
+        bigIntEnabled = enabled;
+        return;
+    }
+
+    if (bigIntNamespaces == NULL)
+        bigIntNamespaces = g_hash_table_new (g_str_hash, g_str_equal);
+
+    const char *key = g_intern_string (ns);
+
+    if (enabled)
+        g_hash_table_add (bigIntNamespaces, (gpointer) key);
+    else
+        g_hash_table_remove (bigIntNamespaces, key);
+}
+
+bool UseBigInt (GIBaseInfo *info) {
+    if (bigIntEnabled)
+        return true;
+
+    if (bigIntNamespaces == NULL || info == NULL)
+        return false;
+
+    return g_hash_table_contains (bigIntNamespaces, g_base_info_get_namespace (info));
+}
+
+Local<Value> Int64ToV8 (gint64 value, bool use_bigint) {
+    if (use_bigint)
+        return v8::BigInt::New (v8::Isolate::GetCurrent (), value);
+
+    // Fast path: values that fit in a Smi
+    if (value >= G_MININT32 && value <= G_MAXINT32)
+        return New<v8::Int32> ((int32_t) value);
+
+    return New<Number> ((double) value);
+}
+
+Local<Value> Uint64ToV8 (guint64 value, bool use_bigint) {
+    if (use_bigint)
+        return v8::BigInt::NewFromUnsigned (v8::Isolate::GetCurrent (), value);
+
+    // Fast path: values that fit in a Smi
+    if (value <= G_MAXINT32)
+        return New<v8::Int32> ((int32_t) value);
+
+    return New<Number> ((double) value);
+}
+
+/* 2^63 and 2^64, exactly representable as doubles */
+#define INT64_LIMIT  9223372036854775808.0
+#define UINT64_LIMIT 18446744073709551616.0
+
+/**
+ * Converts a JS number or BigInt to a signed 64-bit integer
+ * @returns false if the value is not an integer, or doesn't fit
+ */
+bool V8ToInt64 (Local<Value> value, gint64 *result) {
+    if (value->IsInt32 ()) {
+        *result = value.As<v8::Int32> ()->Value ();
+        return true;
+    }
+
+    if (value->IsBigInt ()) {
+        bool lossless;
+        *result = value.As<v8::BigInt> ()->Int64Value (&lossless);
+        return lossless;
+    }
+
+    double number = Nan::To<double> (value).FromMaybe (NAN);
+
+    /* Also rejects NaN & infinities */
+    if (!(number >= -INT64_LIMIT && number < INT64_LIMIT) || trunc (number) != number)
+        return false;
+
+    *result = (gint64) number;
+    return true;
+}
+
+/**
+ * Converts a JS number or BigInt to an unsigned 64-bit integer
+ * @returns false if the value is not an integer, or doesn't fit
+ */
+bool V8ToUint64 (Local<Value> value, guint64 *result) {
+    if (value->IsUint32 ()) {
+        *result = value.As<v8::Uint32> ()->Value ();
+        return true;
+    }
+
+    if (value->IsBigInt ()) {
+        bool lossless;
+        *result = value.As<v8::BigInt> ()->Uint64Value (&lossless);
+        return lossless;
+    }
+
+    double number = Nan::To<double> (value).FromMaybe (NAN);
+
+    /* Also rejects NaN & infinities */
+    if (!(number >= 0 && number < UINT64_LIMIT) || trunc (number) != number)
+        return false;
+
+    *result = (guint64) number;
+    return true;
+}
+
+
 static gpointer GIArgumentToHashPointer (const GIArgument *arg, GITypeInfo *type_info) {
     GITypeTag type_tag = GetStorageType(type_info);
 
@@ -11,23 +11,53 @@ using v8::Local;
 
 namespace GNodeJS {
 
-Local<Value> GListToV8  (GITypeInfo *info, GList  *glist);
-Local<Value> GSListToV8 (GITypeInfo *info, GSList *glist);
-Local<Value> GHashToV8 (GITypeInfo *info, GHashTable *hash);
-Local<Value> ArrayToV8  (GITypeInfo *info, gpointer data, long length = -1);
-Local<Value> GIArgumentToV8 (GITypeInfo *type_info, GIArgument *argument, long length = -1);
+/*
+ * @transfer tells if the converted value is owned (adopted) or borrowed: borrowed
+ * boxed values become views tied to @owner, or copies if there is no owner.
+ */
+Local<Value> GListToV8  (GITypeInfo *info, GList  *glist, GITransfer transfer = GI_TRANSFER_EVERYTHING, Local<v8::Object> owner = Local<v8::Object>());
+Local<Value> GSListToV8 (GITypeInfo *info, GSList *glist, GITransfer transfer = GI_TRANSFER_EVERYTHING, Local<v8::Object> owner = Local<v8::Object>());
+Local<Value> GHashToV8 (GITypeInfo *info, GHashTable *hash, GITransfer transfer = GI_TRANSFER_EVERYTHING, Local<v8::Object> owner = Local<v8::Object>());
+Local<Value> ArrayToV8  (GITypeInfo *info, gpointer data, long length = -1, GITransfer transfer = GI_TRANSFER_EVERYTHING, Local<v8::Object> owner = Local<v8::Object>());
+Local<Value> GIArgumentToV8 (GITypeInfo *type_info, GIArgument *argument, long length = -1, GITransfer transfer = GI_TRANSFER_EVERYTHING, Local<v8::Object> owner = Local<v8::Object>());
 
 bool         V8ToGIArgument (GITypeInfo *type_info, GIArgument *argument, Local<Value> value);
 bool         V8ToGIArgument (GITypeInfo *type_info, GIArgument *argument, Local<Value> value, bool may_be_null);
+void         RefTransferredGObject (GITypeInfo *type_info, GIArgument *argument, GITransfer transfer);
+void         UnrefTransferredGObject (GITypeInfo *type_info, GIArgument *argument, GITransfer transfer);
 void         FreeGIArgument (GITypeInfo *type_info, GIArgument *argument, GITransfer transfer = GI_TRANSFER_EVERYTHING, GIDirection direction = GI_DIRECTION_OUT);
 void         FreeGIArgumentArray (GITypeInfo *type_info, GIArgument *arg, GITransfer transfer = GI_TRANSFER_EVERYTHING, GIDirection direction = GI_DIRECTION_OUT, long length = -1);
 bool         CanConvertV8ToGIArgument (GITypeInfo *type_info, Local<Value> value, bool may_be_null);
 
+/*
+ * Converts GValues of a fundamental type. See RegisterGValueConverter.
+ */
+struct GValueConverter {
+    Local<Value> (*to_v8)       (const GValue *gvalue);
+    bool         (*from_v8)     (GValue *gvalue, Local<Value> value);
+    bool         (*can_convert) (GValue *gvalue, Local<Value> value);
+};
+
+void         RegisterGValueConverter  (GType fundamental, const GValueConverter *converter);
+const GValueConverter *GetGValueConverter (GType gtype);
+void         RegisterJSValueConverter (GType gtype, Local<Value> to_js, Local<Value> from_js);
+
 bool         V8ToGValue(GValue *gvalue, Local<Value> value) __attribute__((warn_unused_result));
 Local<Value> GValueToV8(const GValue *gvalue);
 bool         CanConvertV8ToGValue(GValue *gvalue, Local<Value> value);
 
+void         RegisterStructArrayView (Local<v8::Function> view_class);
+bool         IsStructArrayView (Local<Value> value);
+long         GetArrayLikeLength (Local<Value> value);
+
 bool         ValueHasInternalField  (Local<Value> value);
 bool         ValueIsInstanceOfGType (Local<Value> value, GType g_type);
 
+void         SetBigIntMode (bool enabled, const char *ns = NULL);
+bool         UseBigInt     (GIBaseInfo *info);
+Local<Value> Int64ToV8     (gint64  value, bool use_bigint);
+Local<Value> Uint64ToV8    (guint64 value, bool use_bigint);
+bool         V8ToInt64     (Local<Value> value, gint64  *result);
+bool         V8ToUint64    (Local<Value> value, guint64 *result);
+
 };
@@ -0,0 +1,496 @@
+/*
+ * variant.cc
+ *
+ * Native GVariant serialization: unpacks a GVariant to plain JS values and
+ * packs JS values into a GVariant by walking the type string, instead of
+ * going through one introspected call per element.
+ */
+
+#include <string.h>
+#include <glib.h>
+
+#include "boxed.h"
+#include "debug.h"
+#include "macros.h"
+#include "util.h"
+#include "value.h"
+#include "variant.h"
+
+using v8::Array;
+using v8::ArrayBuffer;
+using v8::Boolean;
+using v8::Integer;
+using v8::Isolate;
+using v8::Local;
+using v8::Map;
+using v8::Number;
+using v8::Object;
+using v8::String;
+using v8::Value;
+using Nan::New;
+
+namespace GNodeJS {
+
+static GHashTable *variantTypeCache = NULL;
+
+/**
+ * Gets a parsed GVariantType, cached by type string
+ * @param type_string the type string
+ * @returns the type (do-not-free), or NULL if the type string is invalid
+ */
+const GVariantType *GetVariantType (const char *type_string) {
+    if (variantTypeCache == NULL)
+        variantTypeCache = g_hash_table_new (g_str_hash, g_str_equal);
+
+    auto type = (const GVariantType *) g_hash_table_lookup (variantTypeCache, type_string);
+
+    if (type != NULL)
+        return type;
+
+    if (!g_variant_type_string_is_valid (type_string))
+        return NULL;
+
+    GVariantType *new_type = g_variant_type_new (type_string);
+    g_hash_table_insert (variantTypeCache, g_strdup (type_string), new_type);
+
+    return new_type;
+}
+
+/*
+ * Fixed-size numeric arrays are exchanged as TypedArrays
+ */
+
+static bool IsFixedNumericType (const GVariantType *type) {
+    switch (g_variant_type_peek_string (type)[0]) {
+        case 'y': case 'n': case 'q': case 'i': case 'u':
+        case 'x': case 't': case 'h': case 'd':
+            return true;
+    }
+    return false;
+}
+
+static gsize GetFixedTypeSize (char type_char) {
+    switch (type_char) {
+        case 'y':           return sizeof (guint8);
+        case 'n': case 'q': return sizeof (gint16);
+        case 'i': case 'u':
+        case 'h':           return sizeof (gint32);
+        case 'x': case 't': return sizeof (gint64);
+        case 'd':           return sizeof (gdouble);
+    }
+    g_assert_not_reached ();
+}
+
+static Local<Value> NewTypedArray (char type_char, Local<ArrayBuffer> buffer, size_t length) {
+    switch (type_char) {
+        case 'y': return v8::Uint8Array::New (buffer, 0, length);
+        case 'n': return v8::Int16Array::New (buffer, 0, length);
+        case 'q': return v8::Uint16Array::New (buffer, 0, length);
+        case 'i':
+        case 'h': return v8::Int32Array::New (buffer, 0, length);
+        case 'u': return v8::Uint32Array::New (buffer, 0, length);
+        case 'x': return v8::BigInt64Array::New (buffer, 0, length);
+        case 't': return v8::BigUint64Array::New (buffer, 0, length);
+        case 'd': return v8::Float64Array::New (buffer, 0, length);
+    }
+    g_assert_not_reached ();
+}
+
+static Local<Value> FixedArrayToV8 (GVariant *variant, const GVariantType *element_type) {
+    char type_char = g_variant_type_peek_string (element_type)[0];
+    gsize element_size = GetFixedTypeSize (type_char);
+    gsize n_elements = 0;
+
+    gconstpointer data = g_variant_get_fixed_array (variant, &n_elements, element_size);
+
+    Local<ArrayBuffer> buffer = ArrayBuffer::New (Isolate::GetCurrent (), n_elements * element_size);
+    if (n_elements > 0)
+        memcpy (Util::GetArrayBufferData (buffer), data, n_elements * element_size);
+
+    return NewTypedArray (type_char, buffer, n_elements);
+}
+
+static bool IsStringKey (const GVariantType *type) {
+    return g_variant_type_equal (type, G_VARIANT_TYPE_STRING)
+        || g_variant_type_equal (type, G_VARIANT_TYPE_OBJECT_PATH)
+        || g_variant_type_equal (type, G_VARIANT_TYPE_SIGNATURE);
+}
+
+/**
+ * Unpacks a GVariant recursively
+ * @param variant the variant
+ * @returns a JS value: dictionaries become objects (or Maps for non-string
+ *     keys), tuples & arrays become arrays, and fixed-size numeric arrays
+ *     become TypedArrays
+ */
+Local<Value> UnpackVariant (GVariant *variant) {
+    if (variant == NULL)
+        return Nan::Null ();
+
+    switch (g_variant_classify (variant)) {
+        case G_VARIANT_CLASS_BOOLEAN:
+            return New<Boolean> (g_variant_get_boolean (variant) != FALSE);
+        case G_VARIANT_CLASS_BYTE:
+            return New<v8::Uint32> (g_variant_get_byte (variant));
+        case G_VARIANT_CLASS_INT16:
+            return New<v8::Int32> (g_variant_get_int16 (variant));
+        case G_VARIANT_CLASS_UINT16:
+            return New<v8::Uint32> (g_variant_get_uint16 (variant));
+        case G_VARIANT_CLASS_INT32:
+            return New<v8::Int32> (g_variant_get_int32 (variant));
+        case G_VARIANT_CLASS_UINT32:
+            return New<v8::Uint32> (g_variant_get_uint32 (variant));
+        case G_VARIANT_CLASS_HANDLE:
+            return New<v8::Int32> (g_variant_get_handle (variant));
+        case G_VARIANT_CLASS_INT64:
+            return Int64ToV8 (g_variant_get_int64 (variant), UseBigInt (NULL));
+        case G_VARIANT_CLASS_UINT64:
+            return Uint64ToV8 (g_variant_get_uint64 (variant), UseBigInt (NULL));
+        case G_VARIANT_CLASS_DOUBLE:
+            return New<Number> (g_variant_get_double (variant));
+
+        case G_VARIANT_CLASS_STRING:
+        case G_VARIANT_CLASS_OBJECT_PATH:
+        case G_VARIANT_CLASS_SIGNATURE:
+        {
+            gsize length = 0;
+            const char *data = g_variant_get_string (variant, &length);
+            return New<String> (data, length).ToLocalChecked ();
+        }
+
+        case G_VARIANT_CLASS_VARIANT:
+        {
+            GVariant *child = g_variant_get_variant (variant);
+            Local<Value> result = UnpackVariant (child);
+            g_variant_unref (child);
+            return result;
+        }
+
+        case G_VARIANT_CLASS_MAYBE:
+        {
+            GVariant *child = g_variant_get_maybe (variant);
+            if (child == NULL)
+                return Nan::Null ();
+            Local<Value> result = UnpackVariant (child);
+            g_variant_unref (child);
+            return result;
+        }
+
+        case G_VARIANT_CLASS_ARRAY:
+        {
+            const GVariantType *element_type = g_variant_type_element (g_variant_get_type (variant));
+
+            if (IsFixedNumericType (element_type))
+                return FixedArrayToV8 (variant, element_type);
+
+            gsize n_children = g_variant_n_children (variant);
+
+            if (g_variant_type_is_dict_entry (element_type)) {
+                bool string_keys = IsStringKey (g_variant_type_key (element_type));
+                Local<Object> object = New<Object> ();
+                Local<Map> map = Map::New (Isolate::GetCurrent ());
+
+                for (gsize i = 0; i < n_children; i++) {
+                    GVariant *entry = g_variant_get_child_value (variant, i);
+                    GVariant *key   = g_variant_get_child_value (entry, 0);
+                    GVariant *value = g_variant_get_child_value (entry, 1);
+
+                    Local<Value> js_key   = UnpackVariant (key);
+                    Local<Value> js_value = UnpackVariant (value);
+
+                    if (string_keys)
+                        Nan::Set (object, js_key, js_value);
+                    else
+                        map->Set (Nan::GetCurrentContext (), js_key, js_value).ToLocalChecked ();
+
+                    g_variant_unref (value);
+                    g_variant_unref (key);
+                    g_variant_unref (entry);
+                }
+
+                if (string_keys)
+                    return object;
+                return map;
+            }
+
+            Local<Array> array = New<Array> (n_children);
+            for (gsize i = 0; i < n_children; i++) {
+                GVariant *child = g_variant_get_child_value (variant, i);
+                Nan::Set (array, i, UnpackVariant (child));
+                g_variant_unref (child);
+            }
+            return array;
+        }
+
+        case G_VARIANT_CLASS_TUPLE:
+        case G_VARIANT_CLASS_DICT_ENTRY:
+        {
+            gsize n_children = g_variant_n_children (variant);
+            Local<Array> array = New<Array> (n_children);
+            for (gsize i = 0; i < n_children; i++) {
+                GVariant *child = g_variant_get_child_value (variant, i);
+                Nan::Set (array, i, UnpackVariant (child));
+                g_variant_unref (child);
+            }
+            return array;
+        }
+    }
+
+    g_assert_not_reached ();
+}
+
+
+static GVariant *ThrowInvalidValue (const GVariantType *type, Local<Value> value) {
+    char *message = g_strdup_printf ("Cannot pack value '%s' as GVariant of type '%.*s'",
+            *Nan::Utf8String (Nan::ToDetailString (value).ToLocalChecked ()),
+            (int) g_variant_type_get_string_length (type),
+            g_variant_type_peek_string (type));
+    Nan::ThrowTypeError (message);
+    g_free (message);
+    return NULL;
+}
+
+static void UnrefFloating (GVariant *variant) {
+    g_variant_unref (g_variant_ref_sink (variant));
+}
+
+/*
+ * Whether @value is a TypedArray of the fixed numeric type @type_char, whose
+ * contents can be copied as is
+ */
+static bool IsMatchingTypedArray (char type_char, Local<Value> value) {
+    switch (type_char) {
+        case 'y': return value->IsUint8Array () || value->IsUint8ClampedArray ();
+        case 'n': return value->IsInt16Array ();
+        case 'q': return value->IsUint16Array ();
+        case 'i':
+        case 'h': return value->IsInt32Array ();
+        case 'u': return value->IsUint32Array ();
+        case 'x': return value->IsBigInt64Array ();
+        case 't': return value->IsBigUint64Array ();
+        case 'd': return value->IsFloat64Array ();
+    }
+    return false;
+}
+
+static GVariant *FixedArrayFromV8 (const GVariantType *type, Local<Value> value) {
+    const GVariantType *element_type = g_variant_type_element (type);
+    gsize element_size = GetFixedTypeSize (g_variant_type_peek_string (element_type)[0]);
+    Nan::TypedArrayContents<uint8_t> contents (value);
+
+    return g_variant_new_fixed_array (element_type,
+            *contents, contents.length () / element_size, element_size);
+}
+
+static GVariant *DictFromV8 (const GVariantType *type, Local<Value> value) {
+    const GVariantType *entry_type = g_variant_type_element (type);
+    const GVariantType *key_type   = g_variant_type_key (entry_type);
+    const GVariantType *value_type = g_variant_type_value (entry_type);
+
+    bool is_map = value->IsMap ();
+    Local<Object> object = TO_OBJECT (value);
+    Local<Array> entries = is_map ?
+        value.As<Map> ()->AsArray () :
+        Nan::GetOwnPropertyNames (object).ToLocalChecked ();
+
+    uint32_t length = entries->Length ();
+    uint32_t step = is_map ? 2 : 1;
+
+    GVariantBuilder builder;
+    g_variant_builder_init (&builder, type);
+
+    for (uint32_t i = 0; i < length; i += step) {
+        Local<Value> js_key = Nan::Get (entries, i).ToLocalChecked ();
+        Local<Value> js_value = is_map ?
+            Nan::Get (entries, i + 1).ToLocalChecked () :
+            Nan::Get (object, js_key).ToLocalChecked ();
+
+        GVariant *key = PackVariant (key_type, js_key);
+        if (key == NULL) {
+            g_variant_builder_clear (&builder);
+            return NULL;
+        }
+
+        GVariant *item = PackVariant (value_type, js_value);
+        if (item == NULL) {
+            UnrefFloating (key);
+            g_variant_builder_clear (&builder);
+            return NULL;
+        }
+
+        g_variant_builder_add_value (&builder, g_variant_new_dict_entry (key, item));
+    }
+
+    return g_variant_builder_end (&builder);
+}
+
+static GVariant *ArrayFromV8 (const GVariantType *type, Local<Value> value) {
+    const GVariantType *element_type = g_variant_type_element (type);
+
+    if (IsFixedNumericType (element_type)
+            && IsMatchingTypedArray (g_variant_type_peek_string (element_type)[0], value))
+        return FixedArrayFromV8 (type, value);
+
+    if (g_variant_type_equal (element_type, G_VARIANT_TYPE_BYTE) && value->IsString ())
+        return g_variant_new_bytestring (*Nan::Utf8String (value));
+
+    if (g_variant_type_is_dict_entry (element_type) && value->IsObject () && !value->IsArray ())
+        return DictFromV8 (type, value);
+
+    /* Other TypedArrays are converted element by element, like arrays */
+    if (!value->IsArray () && !value->IsTypedArray ())
+        return ThrowInvalidValue (type, value);
+
+    Local<Object> array = TO_OBJECT (value);
+    uint32_t length = value->IsArray () ?
+        value.As<Array> ()->Length () :
+        (uint32_t) value.As<v8::TypedArray> ()->Length ();
+
+    GVariantBuilder builder;
+    g_variant_builder_init (&builder, type);
+
+    for (uint32_t i = 0; i < length; i++) {
+        GVariant *child = PackVariant (element_type, Nan::Get (array, i).ToLocalChecked ());
+        if (child == NULL) {
+            g_variant_builder_clear (&builder);
+            return NULL;
+        }
+        g_variant_builder_add_value (&builder, child);
+    }
+
+    return g_variant_builder_end (&builder);
+}
+
+static GVariant *TupleFromV8 (const GVariantType *type, Local<Value> value) {
+    gsize n_items = g_variant_type_n_items (type);
+
+    if (!value->IsArray () || value.As<Array> ()->Length () != n_items)
+        return ThrowInvalidValue (type, value);
+
+    Local<Array> array = value.As<Array> ();
+    GVariant *children[n_items + 1];
+    const GVariantType *child_type = g_variant_type_first (type);
+
+    for (gsize i = 0; i < n_items; i++, child_type = g_variant_type_next (child_type)) {
+        children[i] = PackVariant (child_type, Nan::Get (array, i).ToLocalChecked ());
+
+        if (children[i] == NULL) {
+            for (gsize j = 0; j < i; j++)
+                UnrefFloating (children[j]);
+            return NULL;
+        }
+    }
+
+    if (g_variant_type_is_dict_entry (type))
+        return g_variant_new_dict_entry (children[0], children[1]);
+
+    return g_variant_new_tuple (children, n_items);
+}
+
+/**
+ * Packs a JS value into a GVariant
+ * @param type the type of the variant, must be definite
+ * @param value the JS value
+ * @returns a floating GVariant, or NULL if an exception has been thrown
+ */
+GVariant *PackVariant (const GVariantType *type, Local<Value> value) {
+    GVariant *result = NULL;
+
+    switch (g_variant_type_peek_string (type)[0]) {
+        case 'b':
+            result = g_variant_new_boolean (Nan::To<bool> (value).ToChecked ());
+            break;
+        case 'y':
+            if (value->IsNumber ())
+                result = g_variant_new_byte (Nan::To<uint32_t> (value).ToChecked ());
+            break;
+        case 'n':
+            if (value->IsNumber ())
+                result = g_variant_new_int16 (Nan::To<int32_t> (value).ToChecked ());
+            break;
+        case 'q':
+            if (value->IsNumber ())
+                result = g_variant_new_uint16 (Nan::To<uint32_t> (value).ToChecked ());
+            break;
+        case 'i':
+            if (value->IsNumber ())
+                result = g_variant_new_int32 (Nan::To<int32_t> (value).ToChecked ());
+            break;
+        case 'u':
+            if (value->IsNumber ())
+                result = g_variant_new_uint32 (Nan::To<uint32_t> (value).ToChecked ());
+            break;
+        case 'h':
+            if (value->IsNumber ())
+                result = g_variant_new_handle (Nan::To<int32_t> (value).ToChecked ());
+            break;
+        case 'x':
+        {
+            gint64 number;
+            if ((value->IsNumber () || value->IsBigInt ()) && V8ToInt64 (value, &number))
+                result = g_variant_new_int64 (number);
+            break;
+        }
+        case 't':
+        {
+            guint64 number;
+            if ((value->IsNumber () || value->IsBigInt ()) && V8ToUint64 (value, &number))
+                result = g_variant_new_uint64 (number);
+            break;
+        }
+        case 'd':
+            if (value->IsNumber ())
+                result = g_variant_new_double (Nan::To<double> (value).ToChecked ());
+            break;
+        case 's':
+            if (value->IsString ())
+                result = g_variant_new_string (*Nan::Utf8String (value));
+            break;
+        case 'o':
+        {
+            Nan::Utf8String string (value);
+            if (value->IsString () && g_variant_is_object_path (*string))
+                result = g_variant_new_object_path (*string);
+            break;
+        }
+        case 'g':
+        {
+            Nan::Utf8String string (value);
+            if (value->IsString () && g_variant_is_signature (*string))
+                result = g_variant_new_signature (*string);
+            break;
+        }
+        case 'v':
+            if (ValueIsInstanceOfGType (value, G_TYPE_VARIANT))
+                result = g_variant_new_variant ((GVariant *) BoxedFromWrapper (value));
+            break;
+        case 'm':
+        {
+            const GVariantType *element_type = g_variant_type_element (type);
+            if (value->IsNullOrUndefined ())
+                return g_variant_new_maybe (element_type, NULL);
+
+            GVariant *child = PackVariant (element_type, value);
+            if (child == NULL)
+                return NULL;
+            return g_variant_new_maybe (element_type, child);
+        }
+        case 'a':
+            if (!value->IsObject () && !value->IsString ())
+                break;
+            return ArrayFromV8 (type, value);
+        case '(':
+        case '{':
+            return TupleFromV8 (type, value);
+        default:
+            Nan::ThrowTypeError ("Cannot pack GVariant of indefinite type");
+            return NULL;
+    }
+
+    if (result == NULL)
+        return ThrowInvalidValue (type, value);
+
+    return result;
+}
+
+};
@@ -0,0 +1,17 @@
+
+#pragma once
+
+#include <node.h>
+#include <nan.h>
+#include <glib.h>
+
+using v8::Local;
+using v8::Value;
+
+namespace GNodeJS {
+
+const GVariantType * GetVariantType    (const char *type_string);
+Local<Value>         UnpackVariant       (GVariant *variant);
+GVariant *           PackVariant       (const GVariantType *type, Local<Value> value);
+
+};
@@ -116,6 +116,31 @@ common.describe('return value', () => {
 })
 
 
+common.describe('returns the value of the callback', () => {
+  const store = Gio.ListStore.new(Gtk.Label.gtype)
+  store.append(new Gtk.Label({ label: 'a' }))
+  store.append(new Gtk.Label({ label: 'b' }))
+
+  const first = store.insertSorted(new Gtk.Label({ label: 'first' }), () => -1)
+  const last = store.insertSorted(new Gtk.Label({ label: 'last' }), () => 1)
+
+  common.expect(first, 0)
+  common.expect(last, 3)
+})
+
+
+common.describe('releases call-scoped callbacks after the call', () => {
+  const store = Gio.ListStore.new(Gtk.Label.gtype)
+  const before = gi.System.census().callbacks.count
+
+  for (let i = 0; i < 100; i++)
+    store.insertSorted(new Gtk.Label(), () => 1)
+
+  common.expect(store.getNItems(), 100)
+  common.expect(gi.System.census().callbacks.count, before)
+})
+
+
 /*
  * propagates exceptions
  */
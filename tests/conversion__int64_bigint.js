@@ -0,0 +1,54 @@
+/*
+ * conversion__int64_bigint.js
+ */
+
+
+const gi = require('../lib/')
+const GLib = gi.require('GLib')
+const common = require('./__common__.js')
+
+common.describe('64-bit integers', () => {
+  common.it('are numbers by default', () => {
+    const result = GLib.getMonotonicTime()
+    common.assert(typeof result === 'number', 'result is not a number: ' + typeof result)
+  })
+
+  common.it('are BigInts in BigInt mode', () => {
+    gi.setBigIntMode(true, 'GLib')
+
+    const big = 2n ** 62n + 1n
+    const variant = GLib.Variant.newInt64(big)
+    const result = variant.getInt64()
+    common.assert(result === big, 'value lost precision: ' + result)
+    common.assert(typeof GLib.getMonotonicTime() === 'bigint')
+
+    gi.setBigIntMode(false, 'GLib')
+  })
+
+  common.it('accept numbers in BigInt mode', () => {
+    gi.setBigIntMode(true)
+
+    const variant = GLib.Variant.newUint64(42)
+    common.assert(variant.getUint64() === 42n)
+
+    gi.setBigIntMode(false)
+  })
+
+  common.it('reject NaN', common.mustThrow(/out of range for a 64-bit integer/,
+    () => GLib.Variant.newInt64(NaN)))
+  common.it('reject infinities', common.mustThrow(/out of range for an unsigned 64-bit integer/,
+    () => GLib.Variant.newUint64(Infinity)))
+  common.it('reject fractional numbers', common.mustThrow(/out of range for a 64-bit integer/,
+    () => GLib.Variant.newInt64(1.5)))
+  common.it('reject numbers out of range', common.mustThrow(/out of range for a 64-bit integer/,
+    () => GLib.Variant.newInt64(2 ** 63)))
+  common.it('reject negative unsigned numbers', common.mustThrow(/out of range for an unsigned 64-bit integer/,
+    () => GLib.Variant.newUint64(-1)))
+  common.it('reject BigInts out of range', common.mustThrow(/out of range for an unsigned 64-bit integer/,
+    () => GLib.Variant.newUint64(2n ** 64n)))
+
+  common.it('accept integral numbers up to the limits', () => {
+    common.expect(GLib.Variant.newInt64(-(2 ** 53)).getInt64(), -(2 ** 53))
+    common.expect(GLib.Variant.newUint64(2 ** 53).getUint64(), 2 ** 53)
+  })
+})
@@ -0,0 +1,44 @@
+/*
+ * conversion__struct_array.js
+ */
+
+
+const gi = require('../lib/')
+const GLib = gi.require('GLib')
+const common = require('./__common__.js')
+
+common.describe('arrays of inline structs', () => {
+  common.it('accept arrays of struct instances', () => {
+    const pollFD = new GLib.PollFD()
+    pollFD.fd = 0
+    pollFD.events = 0
+
+    const result = GLib.poll([pollFD], 0)
+    common.expect(result, 0)
+  })
+
+  common.it('accept struct array views', () => {
+    const layout = [['fd', 0, 'gint32'], ['events', 4, 'guint16'], ['revents', 6, 'guint16']]
+    const view = new gi.StructArrayView(GLib.PollFD, new ArrayBuffer(16), 2, 8, layout)
+
+    view.fields.fd.set(1, 0)
+    view.fields.events.set(1, 0)
+    common.expect(view.fields.fd.get(1), 0)
+    common.expect(view.fields.events.toArray().length, 2)
+
+    const result = GLib.poll(view, 0)
+    common.expect(result, 0)
+  })
+
+  common.it('reject views of another struct', common.mustThrow('Struct array view is not an array of GLib.PollFD', () => {
+    const layout = [['tv_sec', 0, 'gint64'], ['tv_usec', 8, 'gint64']]
+    const view = new gi.StructArrayView(GLib.TimeVal, new ArrayBuffer(16), 2, 8, layout)
+    GLib.poll(view, 0)
+  }))
+
+  common.it('reject views smaller than their length', common.mustThrow('Struct array view is smaller than its length', () => {
+    const layout = [['fd', 0, 'gint32'], ['events', 4, 'guint16'], ['revents', 6, 'guint16']]
+    const view = new gi.StructArrayView(GLib.PollFD, new ArrayBuffer(8), 2, 8, layout)
+    GLib.poll(view, 0)
+  }))
+})
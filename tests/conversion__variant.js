@@ -0,0 +1,59 @@
+/*
+ * conversion__variant.js
+ */
+
+
+const gi = require('../lib/')
+const GLib = gi.require('GLib')
+const common = require('./__common__.js')
+
+common.describe('GLib.Variant', () => {
+  common.it('unpacks dictionaries to objects', () => {
+    const variant = GLib.Variant.pack('a{sv}', {
+      name: GLib.Variant.pack('s', 'hello'),
+      count: GLib.Variant.pack('i', 42),
+    })
+    const result = variant.deepUnpack()
+    common.expect(result.name, 'hello')
+    common.expect(result.count, 42)
+  })
+
+  common.it('unpacks fixed numeric arrays to TypedArrays', () => {
+    const variant = GLib.Variant.pack('ai', new Int32Array([1, -2, 3]))
+    const result = variant.deepUnpack()
+    common.assert(result instanceof Int32Array, 'result is not an Int32Array')
+    common.expect(result.join(','), '1,-2,3')
+
+    const bytes = GLib.Variant.pack('ay', [1, 2, 255]).deepUnpack()
+    common.assert(bytes instanceof Uint8Array, 'result is not an Uint8Array')
+    common.expect(bytes.join(','), '1,2,255')
+  })
+
+  common.it('packs other TypedArrays element by element', () => {
+    const ints = GLib.Variant.pack('ai', new Uint8Array([1, 2, 255])).deepUnpack()
+    common.assert(ints instanceof Int32Array, 'result is not an Int32Array')
+    common.expect(ints.join(','), '1,2,255')
+
+    const doubles = GLib.Variant.pack('ad', new Int32Array([-1, 2])).deepUnpack()
+    common.assert(doubles instanceof Float64Array, 'result is not a Float64Array')
+    common.expect(doubles.join(','), '-1,2')
+  })
+
+  common.it('throws on DataViews', common.mustThrow(/Cannot pack value/, () => {
+    GLib.Variant.pack('ai', new DataView(new ArrayBuffer(8)))
+  }))
+
+  common.it('packs tuples, maybes and non-string keys', () => {
+    const variant = GLib.Variant.pack('(sma{ud})', ['a', new Map([[1, 0.5]])])
+    const [string, map] = variant.deepUnpack()
+    common.expect(string, 'a')
+    common.assert(map instanceof Map, 'result is not a Map')
+    common.expect(map.get(1), 0.5)
+
+    common.expect(GLib.Variant.pack('(ms)', [null]).deepUnpack()[0], null)
+  })
+
+  common.it('throws on invalid values', common.mustThrow(/Cannot pack value/, () => {
+    GLib.Variant.pack('as', ['a', 2])
+  }))
+})
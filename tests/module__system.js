@@ -4,7 +4,9 @@
 
 
 const gi = require('../lib/')
+const Gdk = gi.require('Gdk')
 const Gtk = gi.require('Gtk')
+const GdkPixbuf = gi.require('GdkPixbuf')
 const common = require('./__common__.js')
 const system = gi.System
 
@@ -32,4 +34,100 @@ common.describe('system', () => {
     const result = system.addressOf(btn)
     common.assert(/0x[0-9a-fA-F]{2,}/.test(result), 'internalFieldCount() result isnt valid: ' + result)
   })
+
+  common.it('.toggleStats()', () => {
+    const box = new Gtk.Box()
+    const label = new Gtk.Label()
+    const before = system.toggleStats()
+    for (let i = 0; i < 100; i++) {
+      box.add(label)
+      box.remove(label)
+    }
+    const stats = system.toggleStats()
+    common.assert(typeof stats.applied === 'number', 'toggleStats().applied isnt valid')
+    common.assert(typeof stats.coalesced === 'number', 'toggleStats().coalesced isnt valid')
+    common.assert(stats.pending >= 0, 'toggleStats().pending isnt valid')
+    /* Each add cancels the pending toggle down of the previous remove. A GC
+     * during the loop may drain the queue once. */
+    common.assert(stats.coalesced - before.coalesced >= 98,
+      'toggles were not coalesced: ' + (stats.coalesced - before.coalesced))
+    common.assert(stats.applied - before.applied <= 2,
+      'toggles were applied: ' + (stats.applied - before.applied))
+    common.expect(label.label, '')
+  })
+
+  common.it('.toggleStats() drains during synchronous code', () => {
+    for (let i = 0; i < 5000; i++)
+      new Gtk.Label()
+    common.assert(system.toggleStats().pending <= 1024 + 1,
+      'pending toggles grew unbounded: ' + system.toggleStats().pending)
+  })
+
+  common.it('.finalizationStats()', () => {
+    const stats = system.finalizationStats()
+    common.assert(stats.pending >= 0, 'finalizationStats().pending isnt valid')
+    common.assert(typeof stats.released === 'number', 'finalizationStats().released isnt valid')
+    common.assert(typeof stats.lastDrainUsec === 'number', 'finalizationStats().lastDrainUsec isnt valid')
+    common.assert(typeof stats.maxLatencyUsec === 'number', 'finalizationStats().maxLatencyUsec isnt valid')
+
+    if (!global.gc)
+      return
+
+    (() => {
+      for (let i = 0; i < 10; i++)
+        new Gtk.Adjustment()
+    })()
+
+    /* Collected wrappers release their object later, from the loop */
+    global.gc()
+    const collected = system.finalizationStats()
+    common.assert(collected.pending > 0, 'finalizationStats().pending isnt deferred')
+
+    setTimeout(() => {
+      const drained = system.finalizationStats()
+      common.expect(drained.pending, 0)
+      common.assert(drained.released >= collected.released + collected.pending,
+        'finalizationStats().released isnt valid')
+    }, 10)
+  })
+
+  common.it('.externalMemory()', () => {
+    const before = system.externalMemory()
+    const pixbuf = GdkPixbuf.Pixbuf.new(GdkPixbuf.Colorspace.RGB, false, 8, 1000, 1000)
+    const after = system.externalMemory()
+    common.assert(after - before >= 1000 * 1000 * 3, 'externalMemory() doesnt include the pixel data: ' + (after - before))
+    common.expect(pixbuf.getWidth(), 1000)
+  })
+
+  common.it('.externalMemory() doesnt count borrowed memory', () => {
+    const event = new Gdk.Event(Gdk.EventType.MOTION_NOTIFY)
+    /* Releases earlier wrappers, which would lower the count */
+    if (global.gc)
+      global.gc()
+    const before = system.externalMemory()
+    const views = []
+    for (let i = 0; i < 10; i++)
+      views.push(event.motion)
+    gi.withRegion(() => {
+      for (let i = 0; i < 10; i++)
+        views.push(new Gdk.Rectangle())
+    })
+    common.expect(system.externalMemory(), before)
+  })
+
+  common.it('.census()', () => {
+    const before = system.census()
+    const buttons = [new Gtk.Button(), new Gtk.Button()]
+    buttons[0].connect('clicked', () => {})
+    const after = system.census()
+
+    const count = (census, kind, group) =>
+      census[kind].groups[group] ? census[kind].groups[group].count : 0
+
+    common.expect(count(after, 'gobjects', 'GtkButton') - count(before, 'gobjects', 'GtkButton'), 2)
+    common.expect(count(after, 'closures', 'GtkButton') - count(before, 'closures', 'GtkButton'), 1)
+    common.assert(after.gobjects.bytes > before.gobjects.bytes, 'census().gobjects.bytes isnt valid')
+    common.assert(after.callbacks.pending >= 0, 'census().callbacks.pending isnt valid')
+    common.assert(typeof after.functions.count === 'number', 'census().functions isnt valid')
+  })
 })
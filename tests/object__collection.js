@@ -0,0 +1,68 @@
+/*
+ * object__collection.js
+ */
+
+
+const gi = require('../lib/')
+const GObject = gi.require('GObject')
+const Gio = gi.require('Gio')
+const Gtk = gi.require('Gtk', '3.0')
+const common = require('./__common__.js')
+const system = gi.System
+
+Gtk.init()
+
+if (!global.gc)
+  common.skip()
+
+/* Lets the toggle & finalization queues drain */
+const tick = () => new Promise(resolve => setTimeout(resolve, 10))
+
+async function collect() {
+  for (let i = 0; i < 3; i++) {
+    global.gc()
+    await tick()
+  }
+}
+
+async function main() {
+  console.log('collected wrappers: finalize their object')
+  {
+    let isFinalized
+    (() => {
+      const object = new Gio.Cancellable()
+      isFinalized = system.weakRef(object)
+    })()
+
+    await collect()
+    common.assert(isFinalized(), 'object was not finalized')
+  }
+
+  console.log('collected wrappers: can be toggled before their object is released')
+  {
+    const source = new Gtk.Adjustment({ upper: 100 })
+    let isFinalized
+    (() => {
+      const target = new Gtk.Adjustment({ upper: 100 })
+      source.bindProperty('value', target, 'value', GObject.BindingFlags.DEFAULT)
+      isFinalized = system.weakRef(target)
+    })()
+
+    /* The target's wrapper becomes weak, then is collected */
+    await tick()
+    global.gc()
+
+    /* The binding refs & unrefs the target while its release is queued */
+    source.value = 50
+
+    await collect()
+    common.assert(isFinalized(), 'target was not finalized')
+    common.expect(system.toggleStats().pending, 0)
+    common.expect(system.finalizationStats().pending, 0)
+  }
+}
+
+main().catch(error => {
+  console.error(error)
+  process.exit(1)
+})
@@ -0,0 +1,93 @@
+/*
+ * object__dispose.js
+ */
+
+
+const gi = require('../lib/')
+const Gio = gi.require('Gio')
+const Gtk = gi.require('Gtk')
+const common = require('./__common__.js')
+
+Gtk.init()
+
+common.describe('GObject#dispose()', () => {
+
+  common.it('detaches the wrapper', () => {
+    const object = new Gio.Cancellable()
+    object.dispose()
+    common.expect(String(object), '[GCancellable (disposed)]')
+    common.expect(object.__gtype__, undefined)
+  })
+
+  common.it('finalizes objects created with new', () => {
+    const object = new Gio.Cancellable()
+    const isFinalized = gi.System.weakRef(object)
+    object.dispose()
+    common.assert(isFinalized(), 'object was not finalized')
+  })
+
+  common.it('finalizes floating objects created with new', () => {
+    const label = new Gtk.Label()
+    const isFinalized = gi.System.weakRef(label)
+    label.dispose()
+    common.assert(isFinalized(), 'label was not finalized')
+  })
+
+  common.it('finalizes objects returned with their ownership', () => {
+    const file = Gio.File.newForPath('/tmp')
+    const isFinalized = gi.System.weakRef(file)
+    file.dispose()
+    common.assert(isFinalized(), 'file was not finalized')
+  })
+
+  common.it('keeps objects referenced elsewhere alive', () => {
+    const box = new Gtk.Box()
+    let label = new Gtk.Label({ label: 'Hello' })
+    box.add(label)
+    label.dispose()
+
+    label = box.getChildren()[0]
+    common.expect(label.label, 'Hello')
+
+    const isFinalized = gi.System.weakRef(label)
+    label.dispose()
+    common.assert(!isFinalized(), 'label was finalized while in a container')
+  })
+
+  common.it('disconnects the handlers of objects that stay alive', () => {
+    const box = new Gtk.Box()
+    let label = new Gtk.Label({ label: 'Hello' })
+    let count = 0
+    box.add(label)
+    label.connect('notify::label', () => { count++ })
+    label.dispose()
+
+    label = box.getChildren()[0]
+    label.label = 'World'
+    common.expect(count, 0)
+  })
+
+  common.it('can be called several times', () => {
+    const label = new Gtk.Label()
+    label.dispose()
+    label.dispose()
+  })
+
+  common.it('makes later method calls throw', common.mustThrow('Object has been disposed', () => {
+    const label = new Gtk.Label()
+    label.dispose()
+    label.getText()
+  }))
+
+  common.it('makes later property accesses throw', common.mustThrow('Object has been disposed', () => {
+    const label = new Gtk.Label()
+    label.dispose()
+    label.label
+  }))
+
+  common.it('makes later signal connections throw', common.mustThrow('Object has been disposed', () => {
+    const button = new Gtk.Button()
+    button.dispose()
+    button.connect('clicked', () => {})
+  }))
+})
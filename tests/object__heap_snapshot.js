@@ -0,0 +1,32 @@
+/*
+ * object__heap_snapshot.js
+ */
+
+
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+const v8 = require('v8')
+const gi = require('../lib/')
+const Gtk = gi.require('Gtk', '3.0')
+const common = require('./__common__.js')
+
+Gtk.init()
+
+common.describe('heap snapshots', () => {
+  common.it('include the native objects of wrappers', () => {
+    if (!v8.writeHeapSnapshot)
+      return
+
+    const button = new Gtk.Button()
+    button.connect('clicked', () => {})
+
+    const filename = path.join(os.tmpdir(), `node-gtk-${process.pid}.heapsnapshot`)
+    v8.writeHeapSnapshot(filename)
+    const snapshot = fs.readFileSync(filename, 'utf8')
+    fs.unlinkSync(filename)
+
+    common.assert(snapshot.includes('GObject GtkButton'), 'no node for the GtkButton')
+    common.assert(snapshot.includes('GClosure clicked'), 'no node for the signal closure')
+  })
+})
@@ -28,3 +28,51 @@ common.describe('WrapperFromGObject', () => {
   const result = Gtk.Button.newFromStock(Gtk.STOCK_YES)
   console.log(result)
 })
+
+
+common.describe('construct property plans', () => {
+  common.it('reuses plans for repeated key sets', () => {
+    for (let i = 0; i < 1000; i++) {
+      const label = new Gtk.Label({ label: 'row ' + i, selectable: i % 2 === 0 })
+      common.expect(label.label, 'row ' + i)
+      common.expect(label.selectable, i % 2 === 0)
+    }
+  })
+
+  common.it('handles different key sets and orders', () => {
+    const a = new Gtk.Label({ label: 'a', wrap: true })
+    const b = new Gtk.Label({ wrap: false, label: 'b' })
+    const c = new Gtk.Label({ label: 'c', unknownKey: 42 })
+    common.expect(a.label + b.label + c.label, 'abc')
+    common.expect(a.wrap, true)
+    common.expect(b.wrap, false)
+  })
+
+  common.it('keeps a plan evicted while its values are read', () => {
+    const options = {
+      selectable: true,
+      get label() {
+        /* Evicts every other plan of GtkLabel */
+        for (let i = 0; i < 20; i++)
+          new Gtk.Label({ ['key' + i]: i, label: 'inner' })
+        return 'outer'
+      },
+    }
+    const label = new Gtk.Label(options)
+    common.expect(label.label, 'outer')
+    common.expect(label.selectable, true)
+  })
+
+  common.it('throws on invalid values with a cached plan', common.mustThrow(
+    /Cannot convert value for property "mnemonic-widget"/,
+    () => new Gtk.Label({ label: 'row', mnemonic_widget: new Gtk.Button() })
+      && new Gtk.Label({ label: 'row', mnemonic_widget: new Gtk.Adjustment() })
+  ))
+
+  common.it('handles more keys than fit on the stack', () => {
+    const options = { label: 'many' }
+    for (let i = 0; i < 40; i++)
+      options['notAProperty' + i] = i
+    common.expect(new Gtk.Label(options).label, 'many')
+  })
+})
@@ -20,3 +20,42 @@ console.log('win.title:', win.title)
 
 if (win.title !== 'New Title')
     process.exit(1)
+
+
+common.describe('native property accessors', () => {
+  common.it('resolve the property for each class', () => {
+    const label = new Gtk.Label({ label: 'a' })
+    const accelLabel = new Gtk.AccelLabel({ label: 'b' })
+    for (let i = 0; i < 100; i++) {
+      label.label = 'a' + i
+      accelLabel.label = 'b' + i
+    }
+    common.expect(label.label, 'a99')
+    common.expect(accelLabel.label, 'b99')
+  })
+
+  common.it('handle interface properties', () => {
+    const box = new Gtk.Box()
+    box.orientation = Gtk.Orientation.VERTICAL
+    common.expect(box.orientation, Gtk.Orientation.VERTICAL)
+  })
+
+  common.it('notify when setting a property', () => {
+    const label = new Gtk.Label()
+    let notified = 0
+    label.connect('notify::label', () => { notified++ })
+    label.label = 'changed'
+    common.expect(notified, 1)
+    common.expect(label.label, 'changed')
+  })
+
+  common.it('throw on objects of another class', common.mustThrow('Object is not a GtkWindow', () => {
+    const getter = Object.getOwnPropertyDescriptor(Gtk.Window.prototype, 'title').get
+    getter.call(new Gtk.Label())
+  }))
+
+  common.it('throw on other receivers', common.mustThrow('Object is not a GObject', () => {
+    const getter = Object.getOwnPropertyDescriptor(Gtk.Window.prototype, 'title').get
+    getter.call({})
+  }))
+})
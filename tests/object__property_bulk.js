@@ -0,0 +1,72 @@
+/*
+ * object__property_bulk.js
+ */
+
+
+const gi = require('../lib/')
+const Gtk = gi.require('Gtk')
+const common = require('./__common__.js')
+
+Gtk.init()
+
+common.describe('bulk properties', () => {
+
+  common.it('sets and gets several properties', () => {
+    const label = new Gtk.Label()
+    label.setProperties({ label: 'Hello', useUnderline: true, 'max-width-chars': 10 })
+    const values = label.getProperties(['label', 'useUnderline', 'max-width-chars'])
+    common.expect(values.label, 'Hello')
+    common.expect(values.useUnderline, true)
+    common.expect(values['max-width-chars'], 10)
+  })
+
+  common.it('coalesces notifications', () => {
+    const label = new Gtk.Label()
+    let notified = 0
+    label.on('notify::label', () => notified++)
+    label.setProperties({ label: 'a' })
+    common.expect(notified, 1)
+  })
+
+  common.it('throws on unknown properties', common.mustThrow(
+    'GtkLabel has no property "notAProperty"',
+    () => new Gtk.Label().setProperties({ notAProperty: 1 })
+  ))
+})
+
+common.describe('batchNotify()', () => {
+
+  common.it('emits notify once per property after the batch', () => {
+    const label = new Gtk.Label()
+    let notified = 0
+    label.on('notify::label', () => notified++)
+
+    const result = gi.batchNotify(() => {
+      for (let i = 0; i < 10; i++)
+        label.label = 'row ' + i
+      common.expect(notified, 0)
+      return 42
+    })
+
+    common.expect(result, 42)
+    common.expect(notified, 1)
+    common.expect(label.label, 'row 9')
+  })
+
+  common.it('ends the batch when the callback throws', () => {
+    const label = new Gtk.Label()
+    let notified = 0
+    label.on('notify::label', () => notified++)
+
+    try {
+      gi.batchNotify(() => {
+        label.label = 'a'
+        throw new Error('failed')
+      })
+    } catch (e) {}
+
+    common.expect(notified, 1)
+    label.label = 'b'
+    common.expect(notified, 2)
+  })
+})
@@ -0,0 +1,76 @@
+/*
+ * object__property_cache.js
+ */
+
+
+const gi = require('../lib/')
+const Gtk = gi.require('Gtk')
+const common = require('./__common__.js')
+
+Gtk.init()
+
+gi.enablePropertyCache(Gtk.Widget, ['visible', 'sensitive'])
+gi.enablePropertyCache(Gtk.Label, ['label'])
+
+common.describe('property cache', () => {
+
+  common.it('returns updated values after writes', () => {
+    const label = new Gtk.Label({ label: 'a' })
+    common.expect(label.label, 'a')
+    common.expect(label.label, 'a')
+    label.label = 'b'
+    common.expect(label.label, 'b')
+    label.setProperties({ label: 'c' })
+    common.expect(label.label, 'c')
+  })
+
+  common.it('is invalidated by native changes', () => {
+    const button = new Gtk.Button()
+    common.expect(button.sensitive, true)
+    button.setSensitive(false)
+    common.expect(button.sensitive, false)
+    button.show()
+    common.expect(button.visible, true)
+    button.hide()
+    common.expect(button.visible, false)
+  })
+
+  common.it('returns updated values inside batchNotify()', () => {
+    const label = new Gtk.Label({ label: 'a' })
+    common.expect(label.label, 'a')
+    gi.batchNotify(() => {
+      label.label = 'b'
+      common.expect(label.label, 'b')
+      /* The label is frozen: its notify is queued until the batch ends */
+      label.setText('c')
+      common.expect(label.label, 'c')
+    })
+    common.expect(label.label, 'c')
+  })
+
+  common.it('can be disabled for subclasses', () => {
+    gi.disablePropertyCache(Gtk.Button, ['sensitive'])
+    const button = new Gtk.Button()
+    common.expect(button.sensitive, true)
+    button.setSensitive(false)
+    common.expect(button.sensitive, false)
+  })
+
+  common.it('is released with the wrapper of a live object', () => {
+    const box = new Gtk.Box()
+    const label = new Gtk.Label({ label: 'a' })
+    box.add(label)
+    common.expect(label.label, 'a')
+    label.dispose()
+
+    /* Notifies the object, which outlived its wrapper & cache */
+    const child = box.getChildren()[0]
+    child.label = 'b'
+    common.expect(child.label, 'b')
+  })
+
+  common.it('throws on unknown properties', common.mustThrow(
+    'GtkLabel has no property "notAProperty"',
+    () => gi.enablePropertyCache(Gtk.Label, ['notAProperty'])
+  ))
+})
@@ -0,0 +1,91 @@
+/*
+ * object__property_types.js
+ */
+
+const gi = require('../lib')
+const GLib = gi.require('GLib')
+const GObject = gi.require('GObject')
+const Gio = gi.require('Gio')
+const internal = require('../lib/native.js')
+const common = require('./__common__.js')
+
+common.describe('properties', () => {
+  common.it('handles flags', () => {
+    const app = new Gio.Application({ flags: Gio.ApplicationFlags.HANDLES_OPEN })
+    common.expect(app.flags, Gio.ApplicationFlags.HANDLES_OPEN)
+
+    app.flags = Gio.ApplicationFlags.NON_UNIQUE
+    common.expect(app.flags, Gio.ApplicationFlags.NON_UNIQUE)
+  })
+
+  common.it('handles strings', () => {
+    const app = new Gio.Application({ application_id: 'org.nodegtk.Test' })
+    common.expect(app.applicationId, 'org.nodegtk.Test')
+  })
+
+  common.it('handles unsigned longs', () => {
+    const stream = Gio.MemoryOutputStream.newResizable()
+    stream.writeBytes(GLib.Bytes.new([1, 2, 3]), null)
+    common.expect(stream.dataSize, 3)
+    common.assert(typeof stream.dataSize === 'number', 'data-size is not a number')
+
+    gi.setBigIntMode(true)
+    common.assert(stream.dataSize === 3n, 'data-size is not a BigInt in BigInt mode')
+    gi.setBigIntMode(false)
+  })
+
+  common.it('rejects negative unsigned longs', common.mustThrow(/out of range for an unsigned long|property "size"/, () => {
+    new Gio.MemoryOutputStream({ size: -1 })
+  }))
+
+  common.it('handles pointers', () => {
+    const stream = new Gio.MemoryOutputStream({ size: 0 })
+    common.expect(stream.data, null)
+
+    const resizable = Gio.MemoryOutputStream.newResizable()
+    resizable.writeBytes(GLib.Bytes.new([1]), null)
+    common.assert(resizable.data !== null && typeof resizable.data === 'object',
+      'data is not an external pointer')
+  })
+
+  common.it('rejects non-pointers', common.mustThrow('Cannot convert value for property "data", expected type gpointer', () => {
+    new Gio.MemoryOutputStream({ data: 42 })
+  }))
+
+  common.it('handles GTypes', () => {
+    const gtype = GObject.typeFromName('GApplication')
+    common.expect(new Gio.ListStore({ item_type: gtype }).itemType, gtype)
+    common.expect(new Gio.ListStore({ item_type: 'GApplication' }).itemType, gtype)
+  })
+
+  common.it('handles variants', () => {
+    const action = Gio.SimpleAction.newStateful('test', null, GLib.Variant.newString('a'))
+    common.expect(action.state.deepUnpack(), 'a')
+
+    action.state = GLib.Variant.newString('b')
+    common.expect(action.state.deepUnpack(), 'b')
+  })
+
+  common.it('rejects non-variants', common.mustThrow(/not instance of GVariant|could not convert value/, () => {
+    const action = Gio.SimpleAction.newStateful('test', null, GLib.Variant.newString('a'))
+    action.state = 'b'
+  }))
+
+  common.it('round-trips through registered value converters', () => {
+    const gtype = GObject.typeFromName('GVariant')
+    const action = Gio.SimpleAction.newStateful('test', null, GLib.Variant.newString('a'))
+
+    internal.RegisterValueConverter(gtype,
+      variant => variant.deepUnpack(),
+      string => GLib.Variant.newString(string))
+    try {
+      common.expect(action.state, 'a')
+      action.state = 'b'
+      common.expect(action.state, 'b')
+    } finally {
+      internal.RegisterValueConverter(gtype, null, null)
+    }
+
+    common.expect(action.state.deepUnpack(), 'b')
+  })
+})
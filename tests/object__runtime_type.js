@@ -0,0 +1,40 @@
+/*
+ * object__runtime_type.js
+ */
+
+
+const gi = require('../lib/')
+const Gtk = gi.require('Gtk')
+const common = require('./__common__.js')
+
+Gtk.init()
+
+common.describe('wrappers use the runtime type', () => {
+
+  common.it('for values typed as a parent class', () => {
+    const box = new Gtk.Box()
+    box.add(new Gtk.Button())
+    const child = box.getChildren()[0] // GtkWidget in the signature
+    common.assert(child instanceof Gtk.Button, 'child is not a Gtk.Button')
+    common.expect(Object.getPrototypeOf(child), Gtk.Button.prototype)
+  })
+
+  common.it('for objects created by GtkBuilder', () => {
+    const builder = Gtk.Builder.newFromString(`
+      <interface>
+        <object class="GtkWindow" id="window">
+          <child><object class="GtkLabel" id="label"><property name="label">Hello</property></object></child>
+        </object>
+      </interface>`, -1)
+    const label = builder.getObject('label')
+    common.assert(label instanceof Gtk.Label, 'label is not a Gtk.Label')
+    common.expect(label.getText(), 'Hello')
+  })
+
+  common.it('for values typed as an interface', () => {
+    const store = new Gtk.ListStore()
+    const view = new Gtk.TreeView({ model: store })
+    const model = view.getModel() // GtkTreeModel interface
+    common.assert(model instanceof Gtk.ListStore, 'model is not a Gtk.ListStore')
+  })
+})
@@ -0,0 +1,43 @@
+/*
+ * object__wrapper_shape.js
+ */
+
+
+const gi = require('../lib/')
+const GObject = gi.require('GObject')
+const Gtk = gi.require('Gtk')
+const common = require('./__common__.js')
+
+Gtk.init()
+
+common.describe('GObject wrappers', () => {
+
+  common.it('have no own properties', () => {
+    const fromConstructor = new Gtk.Label()
+    const box = new Gtk.Box()
+    box.add(new Gtk.Label())
+    const fromReturn = box.getChildren()[0]
+
+    common.expect(Object.getOwnPropertyNames(fromConstructor).length, 0)
+    common.expect(Object.getOwnPropertyNames(fromReturn).length, 0)
+    common.expect(Object.getPrototypeOf(fromReturn), Gtk.Label.prototype)
+  })
+
+  common.it('expose the runtime __gtype__', () => {
+    const label = new Gtk.Label()
+    common.expect(GObject.typeName(label.__gtype__), 'GtkLabel')
+    common.expect(GObject.typeName(new Gtk.Button().__gtype__), 'GtkButton')
+  })
+
+  common.it('keep signal listeners out of the instance', () => {
+    const button = new Gtk.Button()
+    let clicked = 0
+    const onClick = () => clicked++
+    button.on('clicked', onClick)
+    button.clicked()
+    button.off('clicked', onClick)
+    button.clicked()
+    common.expect(clicked, 1)
+    common.expect(Object.getOwnPropertyNames(button).length, 0)
+  })
+})
@@ -0,0 +1,51 @@
+/*
+ * signal__arguments.js
+ */
+
+
+const gi = require('../lib/')
+const Gtk = gi.require('Gtk', '3.0')
+const common = require('./__common__.js')
+
+Gtk.init()
+
+common.describe('signal arguments', () => {
+  common.it('convert objects & unsigned integers', () => {
+    const notebook = new Gtk.Notebook()
+    const first = new Gtk.Label()
+    const second = new Gtk.Label()
+    notebook.appendPage(first, null)
+    notebook.appendPage(second, null)
+    first.show()
+    second.show()
+
+    let args = null
+    notebook.connect('switch-page', (page, pageNum) => { args = [page, pageNum] })
+    notebook.setCurrentPage(1)
+
+    common.assert(args !== null, 'switch-page was not emitted')
+    common.assert(args[0] === second, 'page is not the wrapper of the page')
+    common.expect(args[1], 1)
+  })
+
+  common.it('convert enums', () => {
+    const label = new Gtk.Label()
+    let previous = null
+
+    label.setDirection(Gtk.TextDirection.LTR)
+    label.connect('direction-changed', (direction) => { previous = direction })
+    label.setDirection(Gtk.TextDirection.RTL)
+
+    common.expect(previous, Gtk.TextDirection.LTR)
+  })
+
+  common.it('convert strings', () => {
+    const buffer = new Gtk.TextBuffer()
+    let text = null
+
+    buffer.connect('insert-text', (location, inserted) => { text = inserted })
+    buffer.insertAtCursor('inserted', -1)
+
+    common.expect(text, 'inserted')
+  })
+})
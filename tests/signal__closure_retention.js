@@ -0,0 +1,81 @@
+/*
+ * signal__closure_retention.js
+ */
+
+
+const gi = require('../lib/')
+const Gtk = gi.require('Gtk', '3.0')
+const common = require('./__common__.js')
+
+Gtk.init()
+
+common.describe('signal handlers', () => {
+  common.it('are kept alive by the object they are connected to', () => {
+    const button = new Gtk.Button()
+    let count = 0
+
+    button.connect('clicked', () => { count++ })
+
+    if (global.gc)
+      global.gc()
+
+    button.clicked()
+    common.expect(count, 1)
+  })
+
+  common.it('can be connected more than once', () => {
+    const button = new Gtk.Button()
+    let count = 0
+    const onClick = () => { count++ }
+
+    const first = button.connect('clicked', onClick)
+    button.connect('clicked', onClick)
+    button.disconnect(first)
+
+    if (global.gc)
+      global.gc()
+
+    button.clicked()
+    common.expect(count, 1)
+  })
+
+  common.it('can capture the object they are connected to', () => {
+    const button = new Gtk.Button({ label: 'self' })
+    let label = null
+
+    button.connect('clicked', () => { label = button.getLabel() })
+    button.clicked()
+    common.expect(label, 'self')
+  })
+})
+
+/*
+ * don't keep the object they capture alive
+ */
+if (global.gc) {
+  const tick = () => new Promise(resolve => setTimeout(resolve, 10))
+
+  let isFinalized
+  let count = 0
+
+  ;(() => {
+    const button = new Gtk.Button()
+    button.connect('clicked', () => { count++; button.getLabel() })
+    button.clicked()
+    isFinalized = gi.System.weakRef(button)
+  })()
+
+  ;(async () => {
+    /* The toggle & finalization queues drain between collections */
+    for (let i = 0; i < 3; i++) {
+      global.gc()
+      await tick()
+    }
+    common.expect(count, 1)
+    common.assert(isFinalized(), 'button captured by its handler was not finalized')
+    console.log('Success: handlers capturing their object are collected with it')
+  })().catch(error => {
+    console.error(error)
+    process.exit(1)
+  })
+}
@@ -20,3 +20,16 @@ const common = require('./__common__.js')
   console.log('Result:', result)
   common.assert(result === 100)
 }
+
+/*
+ * scalar fields use native accessors
+ */
+{
+  const rgba = new Gdk.RGBA()
+  rgba.red = 0.5
+  rgba.alpha = 1
+
+  common.assert(rgba.red === 0.5, 'red is ' + rgba.red)
+  common.assert(rgba.alpha === 1, 'alpha is ' + rgba.alpha)
+  common.assert(Object.keys(Gdk.RGBA.prototype).includes('red'))
+}
@@ -0,0 +1,38 @@
+/*
+ * struct__inline_storage.js
+ */
+
+
+const gi = require('../lib/')
+const Gdk = gi.require('Gdk')
+const common = require('./__common__.js')
+
+common.describe('small plain-old-data structs', () => {
+
+  common.it('keep their values', () => {
+    const rects = []
+    for (let i = 0; i < 1000; i++) {
+      const rect = new Gdk.Rectangle()
+      rect.x = i
+      rect.width = 10
+      rects.push(rect)
+    }
+    if (global.gc)
+      global.gc()
+    common.expect(rects[999].x, 999)
+    common.expect(rects[500].width, 10)
+  })
+
+  common.it('can be passed to functions', () => {
+    const a = new Gdk.Rectangle()
+    const b = new Gdk.Rectangle()
+    a.width = a.height = 10
+    b.x = b.y = 5
+    b.width = b.height = 10
+
+    const [intersects, dest] = Gdk.rectangleIntersect(a, b)
+    common.assert(intersects)
+    common.expect(dest.x, 5)
+    common.expect(dest.width, 5)
+  })
+})
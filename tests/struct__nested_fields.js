@@ -0,0 +1,39 @@
+/*
+ * struct__nested_fields.js
+ */
+
+
+const gi = require('../lib/')
+const Gdk = gi.require('Gdk')
+const Gtk = gi.require('Gtk')
+const common = require('./__common__.js')
+
+Gtk.init()
+
+common.describe('nested struct fields', () => {
+
+  common.it('are views into the parent', () => {
+    const event = new Gdk.Event(Gdk.EventType.MOTION_NOTIFY)
+    event.motion.x = 42.5
+
+    common.expect(event.motion.x, 42.5)
+    common.expect(event.motion.type, Gdk.EventType.MOTION_NOTIFY)
+  })
+
+  common.it('can be assigned', () => {
+    const a = new Gdk.Event(Gdk.EventType.MOTION_NOTIFY)
+    const b = new Gdk.Event(Gdk.EventType.MOTION_NOTIFY)
+    a.motion.y = 7
+
+    b.motion = a.motion
+    common.expect(b.motion.y, 7)
+  })
+
+  common.it('keep the parent alive', () => {
+    let motion = new Gdk.Event(Gdk.EventType.MOTION_NOTIFY).motion
+    motion.x = 1
+    if (global.gc)
+      global.gc()
+    common.expect(motion.x, 1)
+  })
+})
@@ -0,0 +1,69 @@
+/*
+ * struct__ownership.js
+ */
+
+
+const gi = require('../lib/')
+const GLib = gi.require('GLib')
+const Gtk = gi.require('Gtk')
+const common = require('./__common__.js')
+
+Gtk.init()
+
+common.describe('boxed ownership', () => {
+
+  common.it('borrowed return values outlive the call', () => {
+    const entry = new Gtk.Entry()
+    entry.setText('hello')
+
+    // gtk_widget_get_path() is transfer-none: copied, the widget may drop it
+    let path = entry.getPath()
+    for (let i = 0; i < 10; i++)
+      path = entry.getPath()
+    if (global.gc)
+      global.gc()
+    common.assert(path.length() > 0)
+  })
+
+  common.it('signal arguments can be kept after the emission', () => {
+    const loop = GLib.MainLoop.new(null, false)
+    let saved = null
+
+    const window = new Gtk.Window()
+    window.on('size-allocate', (allocation) => {
+      saved = allocation
+    })
+    window.showAll()
+    window.resize(100, 100)
+
+    GLib.timeoutAdd(GLib.PRIORITY_DEFAULT, 100, () => { loop.quit(); return false })
+    loop.run()
+    window.destroy()
+
+    if (global.gc)
+      global.gc()
+    common.assert(saved !== null, 'size-allocate was not emitted')
+    common.assert(saved.width > 0, 'width is ' + saved.width)
+  })
+
+  common.it('borrowed boxed values survive their owner replacing them', () => {
+    const entry = new Gtk.Entry()
+    const path = entry.getPath()
+    const length = path.length()
+
+    entry.setName('renamed')
+    entry.getPath()
+    common.expect(path.length(), length)
+  })
+
+  common.it('borrowed return values survive the disposal of their owner', () => {
+    const entry = new Gtk.Entry()
+    const path = entry.getPath()
+    const length = path.length()
+    const isFinalized = gi.System.weakRef(entry)
+
+    entry.dispose()
+    common.assert(isFinalized(), 'entry was not finalized')
+    common.expect(path.length(), length)
+  })
+})
@@ -0,0 +1,36 @@
+/*
+ * struct__region.js
+ */
+
+
+const gi = require('../lib/')
+const Gdk = gi.require('Gdk')
+const common = require('./__common__.js')
+
+common.describe('withRegion', () => {
+
+  common.it('returns the callback result', () => {
+    const result = gi.withRegion(() => {
+      const rect = new Gdk.Rectangle()
+      rect.width = 42
+      return rect.width
+    })
+    common.expect(result, 42)
+  })
+
+  common.it('works with caller-allocated arguments', () => {
+    gi.withRegion(() => {
+      const a = new Gdk.Rectangle()
+      const b = new Gdk.Rectangle()
+      a.width = a.height = b.width = b.height = 10
+      const [intersects, dest] = Gdk.rectangleIntersect(a, b)
+      common.assert(intersects)
+      common.expect(dest.width, 10)
+    })
+  })
+
+  common.it('invalidates escaped values', common.mustThrow(/has been released/, () => {
+    const rect = gi.withRegion(() => new Gdk.Rectangle())
+    rect.x
+  }))
+})